@@ -8,13 +8,420 @@
 #include <sstream>
 #include <algorithm>
 #include <ctime>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <deque>
+#include <string_view>
+#include <stdexcept>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
+// Учет памяти по подсистемам: каждое выделение относится к подсистеме,
+// активной в потоке (MemoryScope), а освобождение - к подсистеме из заголовка блока.
+// Включается при сборке с -DMEMORY_ACCOUNTING: заголовок добавляет 16 байт и
+// несколько атомарных операций к каждому выделению, поэтому по умолчанию выключен.
+// Общее число и объем выделений для бенчмарка считаются всегда
+#ifdef MEMORY_ACCOUNTING
+const bool memoryAccountingEnabled = true;
+#else
+const bool memoryAccountingEnabled = false;
+#endif
+
+enum class MemorySubsystem : uint8_t {
+    Other,
+    Objects,
+    Names,
+    Indexes,
+    Queries,
+    IoBuffers,
+    Logger,
+    Profiler,
+    Count
+};
+
+const char* const memorySubsystemNames[] = {
+    "Прочее", "Хранилище объектов", "Названия и строки", "Индексы",
+    "Результаты запросов", "Буферы ввода-вывода", "Журнал", "Профилировщик"
+};
+
+struct MemoryCounters {
+    atomic<int64_t> liveBytes{0};
+    atomic<int64_t> liveAllocations{0};
+    atomic<uint64_t> totalAllocations{0};
+};
+
+MemoryCounters memoryCounters[static_cast<size_t>(MemorySubsystem::Count)];
+thread_local MemorySubsystem currentMemorySubsystem = MemorySubsystem::Other;
+
+// Счетчики выделений памяти (используются бенчмарком)
+atomic<uint64_t> allocationCount(0);
+atomic<uint64_t> allocatedBytes(0);
+
+class MemoryScope {
+private:
+    MemorySubsystem previous;
+    
+public:
+    explicit MemoryScope(MemorySubsystem subsystem) : previous(currentMemorySubsystem) {
+        currentMemorySubsystem = subsystem;
+    }
+    
+    ~MemoryScope() { currentMemorySubsystem = previous; }
+};
+
+// Заменяются все формы new/delete, кроме выровненных (align_val_t): те остаются
+// стандартными и освобождаются своей парой delete
+#ifdef MEMORY_ACCOUNTING
+// Заголовок блока: размер и подсистема; 16 байт сохраняют выравнивание max_align_t
+const size_t ALLOCATION_HEADER = 16;
+
+void* allocateTracked(size_t size) noexcept {
+    char* block = static_cast<char*>(malloc(size + ALLOCATION_HEADER));
+    if (!block) return nullptr;
+    MemorySubsystem subsystem = currentMemorySubsystem;
+    memcpy(block, &size, sizeof(size));
+    memcpy(block + sizeof(size), &subsystem, sizeof(subsystem));
+    
+    MemoryCounters& counters = memoryCounters[static_cast<size_t>(subsystem)];
+    counters.liveBytes.fetch_add(size, memory_order_relaxed);
+    counters.liveAllocations.fetch_add(1, memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, memory_order_relaxed);
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    return block + ALLOCATION_HEADER;
+}
+#else
+void* allocateTracked(size_t size) noexcept {
+    void* block = malloc(size ? size : 1);
+    if (!block) return nullptr;
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    return block;
+}
+#endif
+
+// noinline: иначе GCC видит free() после встроенного operator new и выдает
+// ложное предупреждение -Wmismatched-new-delete
+#ifdef __GNUC__
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+NOINLINE void releaseTracked(void* ptr) noexcept {
+#ifdef MEMORY_ACCOUNTING
+    if (!ptr) return;
+    char* block = static_cast<char*>(ptr) - ALLOCATION_HEADER;
+    size_t size;
+    MemorySubsystem subsystem;
+    memcpy(&size, block, sizeof(size));
+    memcpy(&subsystem, block + sizeof(size), sizeof(subsystem));
+    
+    MemoryCounters& counters = memoryCounters[static_cast<size_t>(subsystem)];
+    counters.liveBytes.fetch_sub(size, memory_order_relaxed);
+    counters.liveAllocations.fetch_sub(1, memory_order_relaxed);
+    free(block);
+#else
+    free(ptr);
+#endif
+}
+
+void* operator new(size_t size) {
+    void* ptr;
+    while (!(ptr = allocateTracked(size))) {
+        new_handler handler = get_new_handler();
+        if (!handler) throw bad_alloc();
+        handler();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    return operator new(size, nothrow);
+}
+
+NOINLINE void operator delete(void* ptr) noexcept { releaseTracked(ptr); }
+NOINLINE void operator delete[](void* ptr) noexcept { releaseTracked(ptr); }
+NOINLINE void operator delete(void* ptr, size_t) noexcept { releaseTracked(ptr); }
+NOINLINE void operator delete[](void* ptr, size_t) noexcept { releaseTracked(ptr); }
+NOINLINE void operator delete(void* ptr, const nothrow_t&) noexcept { releaseTracked(ptr); }
+NOINLINE void operator delete[](void* ptr, const nothrow_t&) noexcept { releaseTracked(ptr); }
+
+// Профилировщик горячих путей: таймеры и счетчики пишутся в буферы потоков.
+// Пока профилирование выключено, замер стоит одной атомарной загрузки
+class Profiler {
+public:
+    struct Event {
+        const char* name;
+        int64_t start;   // нс от запуска программы
+        int64_t value;   // длительность в нс (таймер) или значение (счетчик)
+        bool counter;
+    };
+    
+private:
+    struct ThreadBuffer {
+        int threadId;
+        vector<Event> events;
+        size_t dropped;
+    };
+    
+    static const size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+    
+    atomic<bool> enabled;
+    chrono::steady_clock::time_point epoch;
+    mutable mutex registryMutex;
+    vector<unique_ptr<ThreadBuffer>> buffers;
+    
+    ThreadBuffer& localBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            lock_guard<mutex> lock(registryMutex);
+            buffers.push_back(unique_ptr<ThreadBuffer>(new ThreadBuffer{static_cast<int>(buffers.size() + 1), {}, 0}));
+            buffer = buffers.back().get();
+        }
+        return *buffer;
+    }
+    
+    void push(const Event& event) {
+        MemoryScope scope(MemorySubsystem::Profiler);
+        ThreadBuffer& buffer = localBuffer();
+        if (buffer.events.size() < MAX_EVENTS_PER_THREAD) {
+            buffer.events.push_back(event);
+        } else {
+            buffer.dropped++;
+        }
+    }
+    
+    static string formatDuration(int64_t ns) {
+        ostringstream out;
+        out.precision(3);
+        if (ns < 1000) out << ns << " нс";
+        else if (ns < 1000000) out << ns / 1e3 << " мкс";
+        else if (ns < 1000000000) out << ns / 1e6 << " мс";
+        else out << ns / 1e9 << " с";
+        return out.str();
+    }
+    
+public:
+    Profiler() : enabled(false), epoch(chrono::steady_clock::now()) {}
+    
+    bool isEnabled() const { return enabled.load(memory_order_relaxed); }
+    void setEnabled(bool value) { enabled.store(value, memory_order_relaxed); }
+    
+    int64_t now() const {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+    }
+    
+    void record(const char* name, int64_t start, int64_t duration) {
+        push({name, start, duration, false});
+    }
+    
+    void count(const char* name, int64_t value) {
+        if (isEnabled()) push({name, now(), value, true});
+    }
+    
+    // Очистка и выгрузка выполняются, когда фоновые потоки не пишут события
+    void reset() {
+        lock_guard<mutex> lock(registryMutex);
+        for (auto& buffer : buffers) {
+            buffer->events.clear();
+            buffer->dropped = 0;
+        }
+    }
+    
+    size_t eventCount() const {
+        lock_guard<mutex> lock(registryMutex);
+        size_t total = 0;
+        for (const auto& buffer : buffers) total += buffer->events.size();
+        return total;
+    }
+    
+    // Формат Chrome trace event (chrome://tracing, Perfetto)
+    bool writeChromeTrace(const string& filename) const {
+        ofstream file(filename);
+        if (!file.is_open()) return false;
+        
+        lock_guard<mutex> lock(registryMutex);
+        file << fixed;
+        file.precision(3);
+        file << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+        bool first = true;
+        for (const auto& buffer : buffers) {
+            for (const Event& event : buffer->events) {
+                file << (first ? "\n" : ",\n");
+                first = false;
+                file << "{\"name\": \"" << event.name << "\", \"pid\": 1, \"tid\": " << buffer->threadId
+                     << ", \"ts\": " << event.start / 1e3;
+                if (event.counter) {
+                    file << ", \"ph\": \"C\", \"args\": {\"value\": " << event.value << "}}";
+                } else {
+                    file << ", \"ph\": \"X\", \"dur\": " << event.value / 1e3 << "}";
+                }
+            }
+        }
+        file << "\n]}\n";
+        return true;
+    }
+    
+    // Сводка задержек по каждому таймеру с гистограммой по степеням двойки
+    void printStats() const {
+        map<string, vector<int64_t>> timers;
+        map<string, pair<size_t, int64_t>> counters;
+        size_t dropped = 0;
+        {
+            lock_guard<mutex> lock(registryMutex);
+            for (const auto& buffer : buffers) {
+                dropped += buffer->dropped;
+                for (const Event& event : buffer->events) {
+                    if (event.counter) {
+                        counters[event.name].first++;
+                        counters[event.name].second += event.value;
+                    } else {
+                        timers[event.name].push_back(event.value);
+                    }
+                }
+            }
+        }
+        
+        if (timers.empty() && counters.empty()) {
+            cout << "Нет собранных событий" << (isEnabled() ? "" : " (профилирование выключено)") << ".\n";
+            return;
+        }
+        
+        for (auto& entry : timers) {
+            vector<int64_t>& samples = entry.second;
+            sort(samples.begin(), samples.end());
+            int64_t total = accumulate(samples.begin(), samples.end(), int64_t(0));
+            cout << "\n" << entry.first << ": вызовов " << samples.size()
+                 << ", всего " << formatDuration(total)
+                 << ", p50 " << formatDuration(samples[samples.size() / 2])
+                 << ", p99 " << formatDuration(samples[(samples.size() - 1) * 99 / 100])
+                 << ", max " << formatDuration(samples.back()) << "\n";
+            
+            vector<size_t> histogram(64, 0);
+            for (int64_t sample : samples) {
+                int bucket = 0;
+                while (bucket < 63 && (int64_t(1) << (bucket + 1)) <= sample) bucket++;
+                histogram[bucket]++;
+            }
+            size_t peak = *max_element(histogram.begin(), histogram.end());
+            for (int bucket = 0; bucket < 64; bucket++) {
+                if (!histogram[bucket]) continue;
+                cout << "  < " << formatDuration(int64_t(1) << (bucket + 1)) << "\t"
+                     << string(1 + histogram[bucket] * 39 / peak, '#') << " " << histogram[bucket] << "\n";
+            }
+        }
+        
+        if (!counters.empty()) cout << "\nСчетчики:\n";
+        for (const auto& entry : counters) {
+            cout << "  " << entry.first << ": событий " << entry.second.first
+                 << ", сумма " << entry.second.second << "\n";
+        }
+        if (dropped) cout << "Отброшено событий (буфер переполнен): " << dropped << "\n";
+    }
+};
+
+// Глобальный профилировщик
+Profiler profiler;
+
+// Замер времени выполнения области видимости
+class ScopedTimer {
+private:
+    const char* name;
+    int64_t start;
+    
+public:
+    explicit ScopedTimer(const char* name) : name(profiler.isEnabled() ? name : nullptr), start(0) {
+        if (this->name) start = profiler.now();
+    }
+    
+    ~ScopedTimer() {
+        if (name) profiler.record(name, start, profiler.now() - start);
+    }
+};
+
+// Текущий объем памяти по подсистемам (без служебных данных malloc)
+void printMemoryUsage() {
+    if (!memoryAccountingEnabled) {
+        cout << "Учет памяти выключен: соберите программу с -DMEMORY_ACCOUNTING.\n";
+        return;
+    }
+    cout << "Подсистема                 Байт      Блоков    Всего выделений\n";
+    int64_t totalBytes = 0, totalBlocks = 0;
+    for (size_t i = 0; i < static_cast<size_t>(MemorySubsystem::Count); i++) {
+        const MemoryCounters& counters = memoryCounters[i];
+        int64_t bytes = counters.liveBytes.load(), blocks = counters.liveAllocations.load();
+        totalBytes += bytes;
+        totalBlocks += blocks;
+        string name = memorySubsystemNames[i];
+        size_t width = count_if(name.begin(), name.end(), [](char ch) { return (ch & 0xC0) != 0x80; });
+        cout << name << string(width < 22 ? 22 - width : 1, ' ');
+        cout.width(12); cout << bytes;
+        cout.width(10); cout << blocks;
+        cout.width(19); cout << counters.totalAllocations.load() << "\n";
+    }
+    cout << "Итого                 ";
+    cout.width(12); cout << totalBytes;
+    cout.width(10); cout << totalBlocks << "\n";
+}
+
+string memoryUsageJson() {
+    if (!memoryAccountingEnabled) return "null";
+    ostringstream json;
+    json << "{";
+    for (size_t i = 0; i < static_cast<size_t>(MemorySubsystem::Count); i++) {
+        const MemoryCounters& counters = memoryCounters[i];
+        static const char* const keys[] = {"other", "objects", "names", "indexes", "queries", "io_buffers", "logger", "profiler"};
+        json << (i ? ", " : "") << "\"" << keys[i] << "\": {\"live_bytes\": " << counters.liveBytes.load()
+             << ", \"live_allocations\": " << counters.liveAllocations.load()
+             << ", \"total_allocations\": " << counters.totalAllocations.load() << "}";
+    }
+    json << "}";
+    return json.str();
+}
+
+int64_t liveBytes(MemorySubsystem subsystem) {
+    return memoryCounters[static_cast<size_t>(subsystem)].liveBytes.load();
+}
+
 // Класс для логирования
 class Logger {
 private:
     ofstream logFile;
+    bool muted = false;
     
 public:
     Logger(const string& filename = "log.txt") {
@@ -27,7 +434,13 @@ public:
         }
     }
     
+    // Отключение записи в файл и консоль (используется бенчмарком)
+    void setMuted(bool value) { muted = value; }
+    
     void log(const string& action) {
+        ScopedTimer timer("Logger::log");
+        MemoryScope memoryScope(MemorySubsystem::Logger);
+        if (muted) return;
         if (logFile.is_open()) {
             time_t now = time(0);
             string timestamp = ctime(&now);
@@ -41,6 +454,16 @@ public:
 // Глобальный логгер
 Logger logger;
 
+// FNV-1a, 64 бита; hash - состояние для продолжения по нескольким фрагментам
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 // Базовый класс для объектов с уникальным ID
 class IdentifiableObject {
 protected:
@@ -93,6 +516,12 @@ bool getBoolInput(const string& prompt) {
     return getValidInput<int>(prompt, 0, 1) == 1;
 }
 
+// Копия строкового поля объекта, учитываемая в подсистеме названий
+string copyName(const string& source) {
+    MemoryScope scope(MemorySubsystem::Names);
+    return source;
+}
+
 // Класс Труба
 class Pipe : public IdentifiableObject {
 private:
@@ -105,12 +534,13 @@ public:
     Pipe() : length(0), diameter(0), underRepair(false) {}
     
     // Конструктор копирования
-    Pipe(const Pipe& other) : IdentifiableObject(other.id), name(other.name), length(other.length), 
+    Pipe(const Pipe& other) : IdentifiableObject(other.id), name(copyName(other.name)), length(other.length), 
                              diameter(other.diameter), underRepair(other.underRepair) {}
     
     // Оператор присваивания
     Pipe& operator=(const Pipe& other) {
         if (this != &other) {
+            MemoryScope scope(MemorySubsystem::Names);
             id = other.id;
             name = other.name;
             length = other.length;
@@ -120,6 +550,22 @@ public:
         return *this;
     }
     
+    bool operator==(const Pipe& other) const {
+        return id == other.id && name == other.name && length == other.length &&
+               diameter == other.diameter && underRepair == other.underRepair;
+    }
+    
+    // Отпечаток содержимого для сравнения с версией из файла
+    uint64_t versionHash() const {
+        size_t nameSize = name.size();
+        uint64_t hash = fnv1a(&id, sizeof(id));
+        hash = fnv1a(&nameSize, sizeof(nameSize), hash);
+        hash = fnv1a(name.data(), nameSize, hash);
+        hash = fnv1a(&length, sizeof(length), hash);
+        hash = fnv1a(&diameter, sizeof(diameter), hash);
+        return fnv1a(&underRepair, sizeof(underRepair), hash);
+    }
+    
     void readFromConsole(int newId) {
         id = newId;
         name = getStringInput("Введите название трубы: ");
@@ -151,13 +597,16 @@ public:
     }
     
     // Геттеры
-    string getName() const { return name; }
+    const string& getName() const { return name; }
     double getLength() const { return length; }
     int getDiameter() const { return diameter; }
     bool isUnderRepair() const { return underRepair; }
     
     // Сеттеры
-    void setName(const string& newName) { name = newName; }
+    void setName(const string& newName) {
+        MemoryScope scope(MemorySubsystem::Names);
+        name = newName;
+    }
     void setLength(double newLength) { length = newLength; }
     void setDiameter(int newDiameter) { diameter = newDiameter; }
     void setUnderRepair(bool repair) { underRepair = repair; }
@@ -175,14 +624,15 @@ public:
     CompressorStation() : totalWorkshops(0), workingWorkshops(0) {}
     
     // Конструктор копирования
-    CompressorStation(const CompressorStation& other) : IdentifiableObject(other.id), name(other.name), 
+    CompressorStation(const CompressorStation& other) : IdentifiableObject(other.id), name(copyName(other.name)), 
                                                        totalWorkshops(other.totalWorkshops), 
                                                        workingWorkshops(other.workingWorkshops), 
-                                                       classification(other.classification) {}
+                                                       classification(copyName(other.classification)) {}
     
     // Оператор присваивания
     CompressorStation& operator=(const CompressorStation& other) {
         if (this != &other) {
+            MemoryScope scope(MemorySubsystem::Names);
             id = other.id;
             name = other.name;
             totalWorkshops = other.totalWorkshops;
@@ -192,6 +642,23 @@ public:
         return *this;
     }
     
+    bool operator==(const CompressorStation& other) const {
+        return id == other.id && name == other.name && totalWorkshops == other.totalWorkshops &&
+               workingWorkshops == other.workingWorkshops && classification == other.classification;
+    }
+    
+    // Отпечаток содержимого для сравнения с версией из файла
+    uint64_t versionHash() const {
+        size_t nameSize = name.size(), classificationSize = classification.size();
+        uint64_t hash = fnv1a(&id, sizeof(id));
+        hash = fnv1a(&nameSize, sizeof(nameSize), hash);
+        hash = fnv1a(name.data(), nameSize, hash);
+        hash = fnv1a(&totalWorkshops, sizeof(totalWorkshops), hash);
+        hash = fnv1a(&workingWorkshops, sizeof(workingWorkshops), hash);
+        hash = fnv1a(&classificationSize, sizeof(classificationSize), hash);
+        return fnv1a(classification.data(), classificationSize, hash);
+    }
+    
     void readFromConsole(int newId) {
         id = newId;
         name = getStringInput("Введите название компрессорной станции: ");
@@ -243,301 +710,2856 @@ public:
     }
     
     // Геттеры
-    string getName() const { return name; }
+    const string& getName() const { return name; }
     int getTotalWorkshops() const { return totalWorkshops; }
     int getWorkingWorkshops() const { return workingWorkshops; }
-    string getClassification() const { return classification; }
+    const string& getClassification() const { return classification; }
     
     // Сеттеры
-    void setName(const string& newName) { name = newName; }
+    void setName(const string& newName) {
+        MemoryScope scope(MemorySubsystem::Names);
+        name = newName;
+    }
     void setTotalWorkshops(int count) { totalWorkshops = count; }
     void setWorkingWorkshops(int count) { workingWorkshops = count; }
-    void setClassification(const string& newClassification) { classification = newClassification; }
+    void setClassification(const string& newClassification) {
+        MemoryScope scope(MemorySubsystem::Names);
+        classification = newClassification;
+    }
 };
 
-// Базовый класс менеджера
-template<typename T>
-class BaseManager {
-protected:
-    map<int, T> objects;
-    int nextId;
-    
-public:
-    BaseManager() : nextId(1) {}
+// Слой вывода результатов: строки формируются в переиспользуемый буфер,
+// страница выводится одной операцией записи
+const size_t RESULT_PAGE_SIZE = 20;
+
+enum class RenderFormat { Table, Csv, Json };
+
+struct ColumnInfo {
+    const char* title;
+    const char* key;
+    size_t width;
+    bool numeric;
+};
+
+class RowWriter {
+private:
+    string& out;
+    RenderFormat format;
+    const vector<ColumnInfo>& columns;
+    size_t column;
+    
+    // Ширина в символах для UTF-8 (байты продолжения не считаются)
+    static size_t displayWidth(const char* text, size_t length) {
+        size_t width = 0;
+        for (size_t i = 0; i < length; i++) {
+            if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) width++;
+        }
+        return width;
+    }
     
-    virtual void addObject() = 0;
+    static size_t prefixBytes(const char* text, size_t length, size_t width) {
+        size_t i = 0;
+        for (size_t symbols = 0; i < length; i++) {
+            if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80 && symbols++ == width) break;
+        }
+        return i;
+    }
     
-    void deleteObject(int id) {
-        auto it = objects.find(id);
-        if (it != objects.end()) {
-            logger.log("Удален объект: ID=" + to_string(id));
-            objects.erase(it);
-            cout << "Объект удален!\n";
-        } else {
-            cout << "Объект с ID=" << id << " не найден!\n";
+    void appendTableCell(const char* text, size_t length, const ColumnInfo& info, bool last) {
+        size_t width = displayWidth(text, length);
+        if (width > info.width) {
+            out.append(text, prefixBytes(text, length, info.width - 1));
+            out += '~';
+            return;
         }
+        if (info.numeric) out.append(info.width - width, ' ');
+        out.append(text, length);
+        if (!info.numeric && !last) out.append(info.width - width, ' ');
     }
     
-    void showAllObjects() const {
-        if (objects.empty()) {
-            cout << "Объекты отсутствуют.\n";
+    void appendCsvCell(const char* text, size_t length, bool quoted) {
+        bool needsQuotes = quoted && any_of(text, text + length, [](char ch) {
+            return ch == ',' || ch == '"' || ch == '\n' || ch == '\r';
+        });
+        if (!needsQuotes) {
+            out.append(text, length);
             return;
         }
-        for (const auto& entry : objects) {
-            entry.second.print();
-            cout << "---\n";
+        out += '"';
+        for (size_t i = 0; i < length; i++) {
+            if (text[i] == '"') out += '"';
+            out += text[i];
         }
+        out += '"';
     }
     
-    T* getObject(int id) {
-        auto it = objects.find(id);
-        return it != objects.end() ? &it->second : nullptr;
+    void appendJsonString(const char* text, size_t length) {
+        out += '"';
+        for (size_t i = 0; i < length; i++) {
+            unsigned char ch = text[i];
+            if (ch == '"' || ch == '\\') {
+                out += '\\';
+                out += ch;
+            } else if (ch < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+                out += escaped;
+            } else {
+                out += ch;
+            }
+        }
+        out += '"';
     }
     
-    bool objectExists(int id) const {
-        return objects.find(id) != objects.end();
+    void emit(const char* text, size_t length, bool quoted) {
+        const ColumnInfo& info = columns[column];
+        bool last = column + 1 == columns.size();
+        switch (format) {
+            case RenderFormat::Table:
+                if (column) out += "  ";
+                appendTableCell(text, length, info, last);
+                break;
+            case RenderFormat::Csv:
+                if (column) out += ',';
+                appendCsvCell(text, length, quoted);
+                break;
+            case RenderFormat::Json:
+                if (column) out += ", ";
+                out += '"';
+                out += info.key;
+                out += "\": ";
+                if (quoted) appendJsonString(text, length);
+                else out.append(text, length);
+                break;
+        }
+        column++;
     }
     
-    vector<int> getAllObjectIds() const {
-        vector<int> ids;
-        for (const auto& entry : objects) {
-            ids.push_back(entry.first);
+public:
+    RowWriter(string& out, RenderFormat format, const vector<ColumnInfo>& columns)
+        : out(out), format(format), columns(columns), column(0) {}
+    
+    void writeHeader() {
+        if (format == RenderFormat::Json) {
+            out += "[\n";
+            return;
+        }
+        size_t totalWidth = 0;
+        for (const ColumnInfo& info : columns) {
+            const char* title = format == RenderFormat::Table ? info.title : info.key;
+            emit(title, strlen(title), false);
+            totalWidth += info.width + 2;
+        }
+        out += '\n';
+        if (format == RenderFormat::Table) {
+            out.append(totalWidth - 2, '-');
+            out += '\n';
         }
-        return ids;
     }
     
-    bool hasObjects() const {
-        return !objects.empty();
+    void beginRow(bool first) {
+        column = 0;
+        if (format == RenderFormat::Json) out += first ? "  {" : ",\n  {";
     }
     
-    int getObjectCount() const {
-        return objects.size();
+    void endRow() {
+        out += format == RenderFormat::Json ? '}' : '\n';
     }
     
-    const map<int, T>& getObjects() const {
-        return objects;
+    void writeFooter(bool empty) {
+        if (format == RenderFormat::Json) out += empty ? "]\n" : "\n]\n";
     }
     
-    int getNextId() {
-        return nextId;
+    void writeInt(int64_t value) {
+        char text[24];
+        auto result = to_chars(text, text + sizeof(text), value);
+        emit(text, result.ptr - text, false);
     }
     
-    void updateNextId() {
-        if (objects.empty()) {
-            nextId = 1;
-        } else {
-            int maxId = 0;
-            for (const auto& entry : objects) {
-                if (entry.first > maxId) {
-                    maxId = entry.first;
-                }
-            }
-            nextId = maxId + 1;
+    // В таблице - два знака после запятой, в CSV/JSON - кратчайшее точное представление;
+    // nan/inf в JSON недопустимы и выводятся как null
+    void writeDouble(double value) {
+        if (format == RenderFormat::Json && !isfinite(value)) {
+            emit("null", 4, false);
+            return;
         }
+        char text[64];
+        auto result = format == RenderFormat::Table
+            ? to_chars(text, text + sizeof(text), value, chars_format::fixed, 2)
+            : to_chars(text, text + sizeof(text), value);
+        emit(text, result.ptr - text, false);
     }
+    
+    void writeText(const string& value) {
+        emit(value.data(), value.size(), true);
+    }
+    
+    void writeBool(bool value) {
+        const char* text = format == RenderFormat::Table ? (value ? "да" : "нет") : (value ? "true" : "false");
+        emit(text, strlen(text), false);
+    }
+};
 
-protected:
-    template<typename Predicate>
-    set<int> findObjects(Predicate pred) const {
-        set<int> result;
-        for (const auto& entry : objects) {
-            if (pred(entry.second)) {
-                result.insert(entry.first);
-            }
+// Описание столбцов и сравнения для каждого типа объектов
+template<typename T>
+struct RowFormat;
+
+template<>
+struct RowFormat<Pipe> {
+    static const vector<ColumnInfo>& columns() {
+        static const vector<ColumnInfo> info = {
+            {"ID", "id", 8, true}, {"Название", "name", 32, false}, {"Длина, км", "length", 10, true},
+            {"Диаметр, мм", "diameter", 11, true}, {"В ремонте", "underRepair", 9, false}};
+        return info;
+    }
+    
+    static void write(RowWriter& row, const Pipe& pipe) {
+        row.writeInt(pipe.getId());
+        row.writeText(pipe.getName());
+        row.writeDouble(pipe.getLength());
+        row.writeInt(pipe.getDiameter());
+        row.writeBool(pipe.isUnderRepair());
+    }
+    
+    static bool less(const Pipe& a, const Pipe& b, size_t column) {
+        switch (column) {
+            case 1: return a.getName() < b.getName();
+            case 2: return a.getLength() < b.getLength();
+            case 3: return a.getDiameter() < b.getDiameter();
+            case 4: return a.isUnderRepair() < b.isUnderRepair();
+            default: return a.getId() < b.getId();
         }
-        return result;
     }
 };
 
-// Менеджер для труб
-class PipeManager : public BaseManager<Pipe> {
-public:
-    void addObject() override {
-        Pipe pipe;
-        pipe.readFromConsole(nextId);
-        objects[nextId] = pipe;
-        nextId++;
-        cout << "Труба создана с ID: " << (nextId - 1) << "\n";
+template<>
+struct RowFormat<CompressorStation> {
+    static const vector<ColumnInfo>& columns() {
+        static const vector<ColumnInfo> info = {
+            {"ID", "id", 8, true}, {"Название", "name", 32, false}, {"Цехов", "totalWorkshops", 6, true},
+            {"Работает", "workingWorkshops", 8, true}, {"Простой, %", "unusedPercentage", 10, true},
+            {"Классификация", "classification", 16, false}};
+        return info;
     }
     
-    void addObject(const Pipe& pipe) {
-        objects[pipe.getId()] = pipe;
-        if (pipe.getId() >= nextId) {
-            nextId = pipe.getId() + 1;
+    static void write(RowWriter& row, const CompressorStation& station) {
+        row.writeInt(station.getId());
+        row.writeText(station.getName());
+        row.writeInt(station.getTotalWorkshops());
+        row.writeInt(station.getWorkingWorkshops());
+        row.writeDouble(station.getUnusedPercentage());
+        row.writeText(station.getClassification());
+    }
+    
+    static bool less(const CompressorStation& a, const CompressorStation& b, size_t column) {
+        switch (column) {
+            case 1: return a.getName() < b.getName();
+            case 2: return a.getTotalWorkshops() < b.getTotalWorkshops();
+            case 3: return a.getWorkingWorkshops() < b.getWorkingWorkshops();
+            case 4: return a.getUnusedPercentage() < b.getUnusedPercentage();
+            case 5: return a.getClassification() < b.getClassification();
+            default: return a.getId() < b.getId();
         }
     }
+};
+
+// Постраничный просмотр снимка результатов. Сортировка ленивая: partial_sort
+// упорядочивает только записи до конца запрошенной страницы
+template<typename T>
+class ResultView {
+private:
+    vector<const T*> rows;
+    size_t pageSize;
+    size_t page;
+    size_t sortColumn;
+    bool descending;
+    size_t sortedPrefix;
+    RenderFormat format;
+    string buffer;
+    
+    void ensureSorted(size_t end) {
+        if (end <= sortedPrefix) return;
+        size_t column = sortColumn;
+        bool reverse = descending;
+        auto compare = [column, reverse](const T* a, const T* b) {
+            if (RowFormat<T>::less(*a, *b, column)) return !reverse;
+            if (RowFormat<T>::less(*b, *a, column)) return reverse;
+            return a->getId() < b->getId();
+        };
+        partial_sort(rows.begin() + sortedPrefix, rows.begin() + end, rows.end(), compare);
+        sortedPrefix = end;
+    }
     
-    void editPipe(int id) {
-        auto pipe = getObject(id);
-        if (pipe) {
-            pipe->toggleRepair();
-        } else {
-            cout << "Труба с ID=" << id << " не найдена!\n";
+public:
+    // Объекты должны оставаться на месте, пока открыт просмотр (узлы map стабильны)
+    template<typename Ids>
+    ResultView(const map<int, T>& objects, const Ids& ids, size_t pageSize = RESULT_PAGE_SIZE)
+        : pageSize(pageSize), page(0), sortColumn(0), descending(false), format(RenderFormat::Table) {
+        MemoryScope scope(MemorySubsystem::Queries);
+        rows.reserve(ids.size());
+        for (int id : ids) {
+            auto it = objects.find(id);
+            if (it != objects.end()) rows.push_back(&it->second);
         }
+        sortedPrefix = rows.size();  // исходный порядок ids показывается без сортировки
     }
     
-    set<int> findPipesByName(const string& nameFilter) const {
-        return findObjects([&](const Pipe& pipe) { return pipe.matchesNameFilter(nameFilter); });
+    explicit ResultView(const map<int, T>& objects, size_t pageSize = RESULT_PAGE_SIZE)
+        : pageSize(pageSize), page(0), sortColumn(0), descending(false), format(RenderFormat::Table) {
+        MemoryScope scope(MemorySubsystem::Queries);
+        rows.reserve(objects.size());
+        for (const auto& entry : objects) rows.push_back(&entry.second);
+        sortedPrefix = rows.size();
     }
     
-    set<int> findPipesByRepair(bool inRepair) const {
-        return findObjects([&](const Pipe& pipe) { return pipe.matchesRepairFilter(inRepair); });
+    size_t size() const { return rows.size(); }
+    size_t pageCount() const { return max<size_t>(1, (rows.size() + pageSize - 1) / pageSize); }
+    size_t currentPage() const { return page; }
+    
+    bool nextPage() {
+        if (page + 1 >= pageCount()) return false;
+        page++;
+        return true;
     }
     
-    void batchEditRepair(const set<int>& pipeIds) {
-        for (int id : pipeIds) editPipe(id);
-        logger.log("Пакетное редактирование: изменено " + to_string(pipeIds.size()) + " труб");
+    bool prevPage() {
+        if (page == 0) return false;
+        page--;
+        return true;
     }
     
-    void loadObjects(const map<int, Pipe>& newObjects) {
-        objects = newObjects;
-        updateNextId();
+    void sortBy(size_t column, bool descendingOrder) {
+        sortColumn = column;
+        descending = descendingOrder;
+        sortedPrefix = 0;
+        page = 0;
     }
-};
-
-// Менеджер для станций
-class StationManager : public BaseManager<CompressorStation> {
-public:
-    void addObject() override {
-        CompressorStation station;
-        station.readFromConsole(nextId);
-        objects[nextId] = station;
+    
+    void setFormat(RenderFormat newFormat) { format = newFormat; }
+    
+    void renderPage(ostream& out) {
+        ScopedTimer timer("ResultView::renderPage");
+        MemoryScope memoryScope(MemorySubsystem::Queries);
+        size_t begin = page * pageSize;
+        size_t end = min(begin + pageSize, rows.size());
+        ensureSorted(end);
+        
+        buffer.clear();
+        RowWriter row(buffer, format, RowFormat<T>::columns());
+        row.writeHeader();
+        for (size_t i = begin; i < end; i++) {
+            row.beginRow(i == begin);
+            RowFormat<T>::write(row, *rows[i]);
+            row.endRow();
+        }
+        row.writeFooter(begin == end);
+        if (format == RenderFormat::Table) {
+            buffer += "Страница " + to_string(page + 1) + "/" + to_string(pageCount()) +
+                      ", записей: " + to_string(rows.size()) + "\n";
+        }
+        out.write(buffer.data(), buffer.size());
+        out.flush();
+    }
+    
+    // Интерактивный просмотр; для одной страницы - только вывод
+    void browse() {
+        renderPage(cout);
+        if (pageCount() <= 1) return;
+        
+        while (true) {
+            cout << "[n] следующая  [p] предыдущая  [s] сортировка  [f] формат  [q] выход: ";
+            string command;
+            if (!(cin >> command)) return;
+            
+            switch (command[0]) {
+                case 'n':
+                    if (!nextPage()) cout << "Это последняя страница.\n";
+                    else renderPage(cout);
+                    break;
+                case 'p':
+                    if (!prevPage()) cout << "Это первая страница.\n";
+                    else renderPage(cout);
+                    break;
+                case 's': {
+                    const vector<ColumnInfo>& columns = RowFormat<T>::columns();
+                    for (size_t i = 0; i < columns.size(); i++) cout << i + 1 << ". " << columns[i].title << "\n";
+                    size_t column = getValidInput<int>("Столбец для сортировки: ", 1, columns.size()) - 1;
+                    bool descendingOrder = getValidInput<int>("Порядок: 1 - по возрастанию, 2 - по убыванию: ", 1, 2) == 2;
+                    sortBy(column, descendingOrder);
+                    renderPage(cout);
+                    break;
+                }
+                case 'f': {
+                    int choice = getValidInput<int>("Формат: 1 - таблица, 2 - CSV, 3 - JSON: ", 1, 3);
+                    setFormat(choice == 1 ? RenderFormat::Table : choice == 2 ? RenderFormat::Csv : RenderFormat::Json);
+                    renderPage(cout);
+                    break;
+                }
+                case 'q':
+                    return;
+                default:
+                    cout << "Неизвестная команда.\n";
+            }
+        }
+    }
+};
+
+// Пакетные операции: BestEffort пропускает неподходящие объекты,
+// Atomic отменяет всю операцию, если хотя бы один объект не найден или не подходит
+enum class BulkMode { BestEffort, Atomic };
+
+struct BulkResult {
+    size_t requested = 0;
+    size_t applied = 0;
+    size_t missing = 0;
+    size_t rejected = 0;
+    bool committed = false;
+};
+
+// Нечеткий поиск по названиям: триграммный индекс отбирает кандидатов,
+// ограниченное расстояние Левенштейна их проверяет и ранжирует
+struct FuzzyMatch {
+    int id;
+    int distance;      // опечаток до ближайшего фрагмента названия
+    int fullDistance;  // опечаток до названия целиком
+    size_t length;
+};
+
+// Декодирует UTF-8 в кодовые точки; при caseInsensitive приводит латиницу
+// и кириллицу к нижнему регистру и заменяет "ё" на "е"
+void foldName(const string& text, bool caseInsensitive, u32string& result) {
+    result.clear();
+    for (size_t i = 0; i < text.size();) {
+        unsigned char lead = text[i];
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        char32_t ch = 0xFFFD;
+        if (length == 0 || i + length > text.size()) {
+            length = 1;
+        } else {
+            ch = length == 1 ? lead : lead & (0xFF >> (length + 1));
+            for (size_t k = 1; k < length; k++) ch = (ch << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+        }
+        i += length;
+        
+        if (caseInsensitive) {
+            if (ch >= U'A' && ch <= U'Z') ch += 0x20;
+            else if (ch >= 0x410 && ch <= 0x42F) ch += 0x20;
+            else if (ch >= 0x400 && ch <= 0x40F) ch += 0x50;
+            if (ch == 0x451) ch = 0x435;
+        }
+        result.push_back(ch);
+    }
+}
+
+u32string foldName(const string& text, bool caseInsensitive) {
+    u32string result;
+    result.reserve(text.size());
+    foldName(text, caseInsensitive, result);
+    return result;
+}
+
+class FuzzyNameIndex {
+private:
+    // Индекс строится по различным названиям: одинаковые имена проверяются один раз.
+    // Каждый ID числится ровно в одном списке; названия, оставшиеся без объектов,
+    // убираются при перестроении, когда их накапливается больше живых.
+    // Название хранится один раз: ключи nameIds ссылаются на строки из names
+    // (deque не перемещает элементы при добавлении), кодовые точки для сравнения
+    // получаются при поиске
+    struct NameEntry {
+        string name;
+        vector<int> ids;
+    };
+    
+    struct Slot {
+        uint32_t nameId;
+        uint32_t position;  // позиция ID в NameEntry::ids
+    };
+    
+    deque<NameEntry> names;
+    unordered_map<string_view, uint32_t> nameIds;
+    unordered_map<uint64_t, vector<uint32_t>> postings;
+    unordered_map<int, Slot> slots;
+    size_t emptyNames;
+    bool built;
+    
+    static uint64_t trigram(char32_t a, char32_t b, char32_t c) {
+        return (static_cast<uint64_t>(a) << 42) | (static_cast<uint64_t>(b) << 21) | c;
+    }
+    
+    // Триграммы с границами слова (индекс) или только внутренние (запрос)
+    static vector<uint64_t> trigrams(const u32string& text, bool padded) {
+        u32string source = padded ? U"  " + text + U" " : text;
+        vector<uint64_t> result;
+        for (size_t i = 0; i + 2 < source.size(); i++) {
+            result.push_back(trigram(source[i], source[i + 1], source[i + 2]));
+        }
+        sort(result.begin(), result.end());
+        result.erase(unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+    
+    // Расстояние от запроса до ближайшей подстроки текста, если оно не больше
+    // maxDistance, иначе maxDistance + 1. Отсечение Укконена: строки столбца
+    // ниже последней со значением <= maxDistance не вычисляются, O(maxDistance * n)
+    static int infixDistance(const u32string& query, const u32string& text, int maxDistance,
+                             vector<int>& column) {
+        int m = static_cast<int>(query.size());
+        int over = maxDistance + 1;
+        column.resize(m + 1);
+        for (int i = 0; i <= m; i++) column[i] = i;
+        int last = min(maxDistance, m);  // последняя строка со значением <= maxDistance
+        int best = m <= maxDistance ? m : over;
+        for (size_t j = 0; j < text.size() && best > 0; j++) {
+            int top = min(last + 1, m);
+            int diagonal = 0;
+            for (int i = 1; i <= top; i++) {
+                int left = i <= last ? column[i] : over;
+                int cost = query[i - 1] == text[j] ? 0 : 1;
+                column[i] = min({left + 1, column[i - 1] + 1, diagonal + cost});
+                diagonal = left;
+            }
+            last = top;
+            while (last > 0 && column[last] > maxDistance) last--;
+            if (last == m) best = min(best, column[m]);
+        }
+        return best;
+    }
+    
+    // Расстояние до текста целиком в полосе |i - j| <= band; точно, если не превышает band
+    static int fullDistance(const u32string& query, const u32string& text, int band, vector<int>& row) {
+        const int infinity = numeric_limits<int>::max() / 2;
+        int m = static_cast<int>(query.size()), n = static_cast<int>(text.size());
+        row.assign(m + 1, infinity);
+        for (int i = 0; i <= min(m, band); i++) row[i] = i;
+        for (int j = 1; j <= n; j++) {
+            int low = max(1, j - band), high = min(m, j + band);
+            int diagonal = row[low - 1];
+            row[low - 1] = low == 1 && j <= band ? j : infinity;
+            for (int i = low; i <= high; i++) {
+                int cost = query[i - 1] == text[j - 1] ? 0 : 1;
+                int value = min({row[i] + 1, row[i - 1] + 1, diagonal + cost});
+                diagonal = row[i];
+                row[i] = value;
+            }
+        }
+        return row[m];
+    }
+    
+    static bool betterMatch(const FuzzyMatch& a, const FuzzyMatch& b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        if (a.fullDistance != b.fullDistance) return a.fullDistance < b.fullDistance;
+        if (a.length != b.length) return a.length < b.length;
+        return a.id < b.id;
+    }
+    
+    void detach(const Slot& slot) {
+        vector<int>& ids = names[slot.nameId].ids;
+        if (slot.position + 1 < ids.size()) {
+            ids[slot.position] = ids.back();
+            slots[ids[slot.position]].position = slot.position;
+        }
+        ids.pop_back();
+        if (ids.empty()) emptyNames++;
+    }
+    
+    // Перестроение без названий, у которых не осталось объектов
+    void compact() {
+        deque<NameEntry> previous;
+        previous.swap(names);
+        clear();
+        built = true;
+        for (NameEntry& entry : previous) {
+            for (int id : entry.ids) add(id, entry.name);
+        }
+    }
+    
+public:
+    FuzzyNameIndex() : emptyNames(0), built(false) {}
+    
+    // Пока индекс не построен, add и remove ничего не делают: он строится при
+    // первом нечетком поиске и после этого поддерживается при каждом изменении
+    bool isBuilt() const { return built; }
+    
+    void clear() {
+        names.clear();
+        nameIds.clear();
+        postings.clear();
+        slots.clear();
+        emptyNames = 0;
+        built = false;
+    }
+    
+    template<typename T>
+    void build(const map<int, T>& objects) {
+        ScopedTimer timer("FuzzyNameIndex::build");
+        MemoryScope memoryScope(MemorySubsystem::Indexes);
+        clear();
+        built = true;
+        slots.reserve(objects.size());
+        for (const auto& entry : objects) add(entry.first, entry.second.getName());
+        for (auto& entry : postings) entry.second.shrink_to_fit();
+    }
+    
+    // Добавляет объект или переносит его к новому названию; повторный вызов с тем же названием ничего не меняет
+    void add(int id, const string& name) {
+        if (!built) return;
+        MemoryScope scope(MemorySubsystem::Indexes);
+        auto found = nameIds.find(string_view(name));
+        bool newName = found == nameIds.end();
+        uint32_t nameId = newName ? static_cast<uint32_t>(names.size()) : found->second;
+        auto slot = slots.find(id);
+        if (slot != slots.end()) {
+            if (slot->second.nameId == nameId) return;
+            detach(slot->second);
+        }
+        if (newName) {
+            names.push_back({name, {}});
+            nameIds.emplace(string_view(names.back().name), nameId);
+            for (uint64_t key : trigrams(foldName(name, true), true)) postings[key].push_back(nameId);
+        } else if (names[nameId].ids.empty()) {
+            emptyNames--;
+        }
+        
+        vector<int>& ids = names[nameId].ids;
+        slots[id] = {nameId, static_cast<uint32_t>(ids.size())};
+        ids.push_back(id);
+        if (emptyNames > names.size() / 2 + 1024) compact();
+    }
+    
+    void remove(int id) {
+        if (!built) return;
+        auto slot = slots.find(id);
+        if (slot == slots.end()) return;
+        detach(slot->second);
+        slots.erase(slot);
+        if (emptyNames > names.size() / 2 + 1024) compact();
+    }
+    
+    // Лучшие topK объектов не более чем с maxDistance опечатками, по возрастанию расстояния
+    vector<FuzzyMatch> search(const string& query, int maxDistance, size_t topK, bool caseInsensitive) const {
+        u32string pattern = foldName(query, caseInsensitive);
+        vector<uint64_t> queryTrigrams = trigrams(foldName(query, true), false);
+        
+        // Совпадение с d опечатками сохраняет не меньше n - 3d триграмм запроса,
+        // поэтому достаточно объединить списки n - need + 1 самых редких триграмм
+        vector<uint32_t> candidates;
+        int need = static_cast<int>(queryTrigrams.size()) - 3 * maxDistance;
+        if (need > 0) {
+            vector<const vector<uint32_t>*> lists;
+            for (uint64_t key : queryTrigrams) {
+                auto it = postings.find(key);
+                lists.push_back(it != postings.end() ? &it->second : nullptr);
+            }
+            sort(lists.begin(), lists.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) {
+                return (a ? a->size() : 0) < (b ? b->size() : 0);
+            });
+            for (size_t i = 0; i < queryTrigrams.size() - need + 1; i++) {
+                if (lists[i]) candidates.insert(candidates.end(), lists[i]->begin(), lists[i]->end());
+            }
+            sort(candidates.begin(), candidates.end());
+            candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+        } else {
+            candidates.resize(names.size());
+            iota(candidates.begin(), candidates.end(), 0);
+        }
+        profiler.count("FuzzyNameIndex::search.candidates", candidates.size());
+        if (topK == 0) return {};
+        
+        // Ограниченная куча: на вершине худший из отобранных
+        auto worse = [](const FuzzyMatch& a, const FuzzyMatch& b) { return betterMatch(a, b); };
+        priority_queue<FuzzyMatch, vector<FuzzyMatch>, decltype(worse)> heap(worse);
+        vector<int> work;
+        u32string text;
+        for (uint32_t nameId : candidates) {
+            const NameEntry& entry = names[nameId];
+            // Когда куча заполнена, порог опускается до расстояний худшего из отобранных.
+            // Байтов в UTF-8 не меньше, чем кодовых точек, поэтому отсев по длине строки безопасен
+            bool heapFull = heap.size() == topK;
+            int limit = heapFull ? min(maxDistance, heap.top().distance) : maxDistance;
+            if (entry.ids.empty() || entry.name.size() + limit < pattern.size()) continue;
+            foldName(entry.name, caseInsensitive, text);
+            int infix = infixDistance(pattern, text, limit, work);
+            if (infix > limit) continue;
+            
+            // Полное расстояние не меньше |n - m| и не больше |n - m| + 2 * infix, поэтому
+            // полоса такой ширины дает точный ответ; более узкая полоса по худшему из кучи
+            // дает точный ответ либо значение больше полосы, которое в кучу не попадет
+            int lengthGap = abs(static_cast<int>(text.size()) - static_cast<int>(pattern.size()));
+            int band = lengthGap + 2 * infix;
+            if (heapFull && infix == heap.top().distance) {
+                if (lengthGap > heap.top().fullDistance) continue;
+                band = min(band, heap.top().fullDistance);
+            }
+            int wholeDistance = fullDistance(pattern, text, band, work);
+            for (int id : entry.ids) {
+                FuzzyMatch match{id, infix, wholeDistance, text.size()};
+                if (heap.size() == topK && !betterMatch(match, heap.top())) continue;
+                heap.push(match);
+                if (heap.size() > topK) heap.pop();
+            }
+        }
+        
+        vector<FuzzyMatch> result;
+        while (!heap.empty()) {
+            result.push_back(heap.top());
+            heap.pop();
+        }
+        reverse(result.begin(), result.end());
+        return result;
+    }
+};
+
+// Слияние с файлом: при конфликте (объект изменен и локально, и во входящем
+// файле относительно последней загруженной версии) побеждает выбранная сторона
+enum class MergePolicy { PreferIncoming, PreferLocal };
+
+struct MergeSummary {
+    size_t inserted = 0;
+    size_t updated = 0;
+    size_t deleted = 0;
+    size_t unchanged = 0;
+    size_t conflicts = 0;
+};
+
+// План слияния хранит только изменения, поэтому память растет с числом
+// изменений, а не с размером входящего файла. Исключение - seen: список всех ID
+// файла собирается, только если отсутствующие в файле объекты нужно удалить
+template<typename T>
+struct MergePlan {
+    vector<T> upserts;
+    vector<int> deletes;
+    vector<pair<int, uint64_t>> rebased;  // новая загруженная версия без изменения объекта
+    vector<int> unbased;                  // объект удален из файла, локальная копия остается
+    bool trackSeen = false;
+    vector<int> seen;
+    MergeSummary summary;
+};
+
+// Базовый класс менеджера
+template<typename T>
+class BaseManager {
+protected:
+    map<int, T> objects;
+    int nextId;
+    mutable FuzzyNameIndex nameIndex;  // строится при первом нечетком поиске, затем поддерживается
+    set<int> localChanges;             // ID, затронутые после последней загрузки
+    unordered_map<int, uint64_t> loadedVersions;  // отпечатки версий из последней загрузки
+    
+    void markChanged(int id) {
+        MemoryScope scope(MemorySubsystem::Indexes);
+        localChanges.insert(id);
+    }
+    
+    // Объект отличается от загруженной версии (изменен, добавлен или удален локально)
+    bool changedLocally(int id) const {
+        if (!localChanges.count(id)) return false;
+        auto base = loadedVersions.find(id);
+        auto it = objects.find(id);
+        if (base == loadedVersions.end()) return it != objects.end();
+        return it == objects.end() || it->second.versionHash() != base->second;
+    }
+    
+    // Состояние сразу после полной загрузки объектов
+    void resetLoadedState() {
+        nameIndex.clear();
+        localChanges.clear();
+        loadedVersions.clear();
+        MemoryScope scope(MemorySubsystem::Indexes);
+        loadedVersions.reserve(objects.size());
+        for (const auto& entry : objects) loadedVersions.emplace(entry.first, entry.second.versionHash());
+        updateNextId();
+    }
+    
+public:
+    BaseManager() : nextId(1) {}
+    
+    virtual void addObject() = 0;
+    
+    void deleteObject(int id) {
+        auto it = objects.find(id);
+        if (it != objects.end()) {
+            logger.log("Удален объект: ID=" + to_string(id));
+            objects.erase(it);
+            nameIndex.remove(id);
+            markChanged(id);
+            cout << "Объект удален!\n";
+        } else {
+            cout << "Объект с ID=" << id << " не найден!\n";
+        }
+    }
+    
+    void showAllObjects() const {
+        if (objects.empty()) {
+            cout << "Объекты отсутствуют.\n";
+            return;
+        }
+        ResultView<T> view(objects);
+        view.browse();
+    }
+    
+    // ids - set (по возрастанию ID) или vector (порядок сохраняется)
+    template<typename Ids>
+    void showObjects(const Ids& ids) const {
+        if (ids.empty()) return;
+        ResultView<T> view(objects, ids);
+        view.browse();
+    }
+    
+    BulkResult bulkDelete(vector<int> ids, BulkMode mode = BulkMode::BestEffort) {
+        ScopedTimer timer("BaseManager::bulkDelete");
+        BulkResult result;
+        auto targets = collectTargets(ids, result);
+        if (mode == BulkMode::Atomic && result.missing) {
+            logBulk("удаление", result);
+            return result;
+        }
+        for (auto it : targets) {
+            markChanged(it->first);
+            nameIndex.remove(it->first);
+            objects.erase(it);
+        }
+        result.applied = targets.size();
+        result.committed = true;
+        logBulk("удаление", result);
+        return result;
+    }
+    
+    // Трехстороннее сравнение входящей записи с загруженной версией и текущим
+    // состоянием: запись, совпадающая с загруженной версией, ничего не меняет
+    void planMerge(const T& incoming, MergePolicy policy, MergePlan<T>& plan) const {
+        int id = incoming.getId();
+        if (plan.trackSeen) plan.seen.push_back(id);
+        uint64_t incomingVersion = incoming.versionHash();
+        auto base = loadedVersions.find(id);
+        auto it = objects.find(id);
+        
+        if (base != loadedVersions.end() && base->second == incomingVersion) {
+            plan.summary.unchanged++;
+            return;
+        }
+        if (it != objects.end() && it->second == incoming) {
+            plan.summary.unchanged++;
+            plan.rebased.push_back({id, incomingVersion});
+            return;
+        }
+        if (changedLocally(id)) {
+            plan.summary.conflicts++;
+            if (policy == MergePolicy::PreferLocal) {
+                plan.rebased.push_back({id, incomingVersion});
+                return;
+            }
+        }
+        plan.upserts.push_back(incoming);
+        (it == objects.end() ? plan.summary.inserted : plan.summary.updated)++;
+    }
+    
+    // Загруженные ранее объекты, отсутствующие во входящем файле, планируются к удалению;
+    // добавленные локально объекты в файле и не могли быть, они сохраняются
+    void planDeletes(MergePolicy policy, MergePlan<T>& plan) const {
+        sort(plan.seen.begin(), plan.seen.end());
+        for (const auto& entry : loadedVersions) {
+            int id = entry.first;
+            if (binary_search(plan.seen.begin(), plan.seen.end(), id)) continue;
+            if (changedLocally(id)) {
+                plan.summary.conflicts++;
+                if (policy == MergePolicy::PreferLocal) {
+                    plan.unbased.push_back(id);
+                    continue;
+                }
+            }
+            if (objects.count(id)) {
+                plan.deletes.push_back(id);
+                plan.summary.deleted++;
+            } else {
+                plan.unbased.push_back(id);
+            }
+        }
+    }
+    
+    // Применяет только изменения плана; индекс названий трогается только для них
+    void applyMerge(const MergePlan<T>& plan) {
+        MemoryScope scope(MemorySubsystem::Objects);
+        for (const T& incoming : plan.upserts) {
+            int id = incoming.getId();
+            auto it = objects.find(id);
+            if (it == objects.end()) {
+                objects.emplace(id, incoming);
+            } else {
+                it->second = incoming;
+            }
+            nameIndex.add(id, incoming.getName());
+            if (id >= nextId) nextId = id + 1;
+            MemoryScope versionsScope(MemorySubsystem::Indexes);
+            loadedVersions[id] = incoming.versionHash();
+            localChanges.erase(id);
+        }
+        for (int id : plan.deletes) {
+            objects.erase(id);
+            nameIndex.remove(id);
+            loadedVersions.erase(id);
+            localChanges.erase(id);
+        }
+        MemoryScope versionsScope(MemorySubsystem::Indexes);
+        for (const auto& entry : plan.rebased) loadedVersions[entry.first] = entry.second;
+        for (int id : plan.unbased) loadedVersions.erase(id);
+    }
+    
+    vector<FuzzyMatch> findObjectsByNameFuzzy(const string& query, int maxDistance, size_t topK,
+                                              bool caseInsensitive) const {
+        ScopedTimer timer("BaseManager::findObjectsByNameFuzzy");
+        MemoryScope memoryScope(MemorySubsystem::Queries);
+        if (!nameIndex.isBuilt()) nameIndex.build(objects);
+        return nameIndex.search(query, maxDistance, topK, caseInsensitive);
+    }
+    
+    T* getObject(int id) {
+        auto it = objects.find(id);
+        return it != objects.end() ? &it->second : nullptr;
+    }
+    
+    bool objectExists(int id) const {
+        return objects.find(id) != objects.end();
+    }
+    
+    vector<int> getAllObjectIds() const {
+        vector<int> ids;
+        for (const auto& entry : objects) {
+            ids.push_back(entry.first);
+        }
+        return ids;
+    }
+    
+    bool hasObjects() const {
+        return !objects.empty();
+    }
+    
+    int getObjectCount() const {
+        return objects.size();
+    }
+    
+    const map<int, T>& getObjects() const {
+        return objects;
+    }
+    
+    int getNextId() {
+        return nextId;
+    }
+    
+    void updateNextId() {
+        if (objects.empty()) {
+            nextId = 1;
+        } else {
+            int maxId = 0;
+            for (const auto& entry : objects) {
+                if (entry.first > maxId) {
+                    maxId = entry.first;
+                }
+            }
+            nextId = maxId + 1;
+        }
+    }
+
+protected:
+    // Сортирует и убирает повторы в ids, затем находит объекты одним проходом
+    // в порядке хранения: близкие ID догоняются инкрементом итератора, далекие - поиском
+    vector<typename map<int, T>::iterator> collectTargets(vector<int>& ids, BulkResult& result) {
+        sort(ids.begin(), ids.end());
+        ids.erase(unique(ids.begin(), ids.end()), ids.end());
+        result.requested = ids.size();
+        
+        vector<typename map<int, T>::iterator> targets;
+        targets.reserve(ids.size());
+        auto it = objects.begin();
+        for (int id : ids) {
+            for (int step = 0; step < 8 && it != objects.end() && it->first < id; step++) ++it;
+            if (it != objects.end() && it->first < id) it = objects.lower_bound(id);
+            if (it != objects.end() && it->first == id) {
+                targets.push_back(it);
+            } else {
+                result.missing++;
+            }
+        }
+        return targets;
+    }
+    
+    // Одна запись в журнал на всю пакетную операцию
+    void logBulk(const string& action, const BulkResult& result) const {
+        profiler.count("BaseManager::bulk.applied", result.applied);
+        string message = "Пакетная операция (" + action + "): применено " + to_string(result.applied) +
+                         " из " + to_string(result.requested);
+        if (result.missing) message += ", не найдено " + to_string(result.missing);
+        if (result.rejected) message += ", отклонено " + to_string(result.rejected);
+        if (!result.committed) message += " - отменена";
+        logger.log(message);
+    }
+    
+    template<typename Check, typename Mutate>
+    BulkResult applyBulk(const string& action, vector<int> ids, BulkMode mode, Check canApply, Mutate mutate,
+                         bool renames = false) {
+        BulkResult result;
+        auto targets = collectTargets(ids, result);
+        vector<T*> accepted;
+        accepted.reserve(targets.size());
+        for (auto it : targets) {
+            if (canApply(it->second)) {
+                accepted.push_back(&it->second);
+            } else {
+                result.rejected++;
+            }
+        }
+        
+        if (mode == BulkMode::Atomic && (result.missing || result.rejected)) {
+            logBulk(action, result);
+            return result;
+        }
+        for (T* object : accepted) {
+            mutate(*object);
+            markChanged(object->getId());
+        }
+        if (renames) {
+            for (T* object : accepted) nameIndex.add(object->getId(), object->getName());
+        }
+        result.applied = accepted.size();
+        result.committed = true;
+        logBulk(action, result);
+        return result;
+    }
+    
+    template<typename Predicate>
+    set<int> findObjects(Predicate pred) const {
+        ScopedTimer timer("BaseManager::findObjects");
+        MemoryScope memoryScope(MemorySubsystem::Queries);
+        set<int> result;
+        for (const auto& entry : objects) {
+            if (pred(entry.second)) {
+                result.insert(entry.first);
+            }
+        }
+        profiler.count("BaseManager::findObjects.matches", result.size());
+        return result;
+    }
+};
+
+// Атрибуты для пакетного изменения (пустые поля не меняются)
+struct PipeAttributes {
+    optional<string> name;
+    optional<double> length;
+    optional<int> diameter;
+    optional<bool> underRepair;
+};
+
+// Менеджер для труб
+class PipeManager : public BaseManager<Pipe> {
+public:
+    void addObject() override {
+        Pipe pipe;
+        pipe.readFromConsole(nextId);
+        MemoryScope scope(MemorySubsystem::Objects);
+        objects[nextId] = pipe;
+        nameIndex.add(nextId, pipe.getName());
+        markChanged(nextId);
         nextId++;
-        cout << "Компрессорная станция создана с ID: " << (nextId - 1) << "\n";
+        cout << "Труба создана с ID: " << (nextId - 1) << "\n";
+    }
+    
+    void addObject(const Pipe& pipe) {
+        MemoryScope scope(MemorySubsystem::Objects);
+        objects[pipe.getId()] = pipe;
+        nameIndex.add(pipe.getId(), pipe.getName());
+        markChanged(pipe.getId());
+        if (pipe.getId() >= nextId) {
+            nextId = pipe.getId() + 1;
+        }
+    }
+    
+    void editPipe(int id) {
+        auto pipe = getObject(id);
+        if (pipe) {
+            pipe->toggleRepair();
+            markChanged(id);
+        } else {
+            cout << "Труба с ID=" << id << " не найдена!\n";
+        }
+    }
+    
+    set<int> findPipesByName(const string& nameFilter) const {
+        ScopedTimer timer("PipeManager::findPipesByName");
+        return findObjects([&](const Pipe& pipe) { return pipe.matchesNameFilter(nameFilter); });
+    }
+    
+    set<int> findPipesByRepair(bool inRepair) const {
+        ScopedTimer timer("PipeManager::findPipesByRepair");
+        return findObjects([&](const Pipe& pipe) { return pipe.matchesRepairFilter(inRepair); });
+    }
+    
+    void batchEditRepair(const set<int>& pipeIds) {
+        ScopedTimer timer("PipeManager::batchEditRepair");
+        profiler.count("PipeManager::batchEditRepair.pipes", pipeIds.size());
+        BulkResult result = bulkToggleRepair(vector<int>(pipeIds.begin(), pipeIds.end()));
+        if (result.missing) cout << "Не найдено труб: " << result.missing << "\n";
+    }
+    
+    BulkResult bulkToggleRepair(vector<int> ids, BulkMode mode = BulkMode::BestEffort) {
+        ScopedTimer timer("PipeManager::bulkToggleRepair");
+        return applyBulk("переключение статуса ремонта", move(ids), mode,
+                         [](const Pipe&) { return true; },
+                         [](Pipe& pipe) { pipe.setUnderRepair(!pipe.isUnderRepair()); });
+    }
+    
+    BulkResult bulkSetRepair(vector<int> ids, bool inRepair, BulkMode mode = BulkMode::BestEffort) {
+        ScopedTimer timer("PipeManager::bulkSetRepair");
+        return applyBulk(string("статус ремонта: ") + (inRepair ? "в ремонте" : "работает"), move(ids), mode,
+                         [](const Pipe&) { return true; },
+                         [inRepair](Pipe& pipe) { pipe.setUnderRepair(inRepair); });
+    }
+    
+    // Заданные поля присваиваются всем объектам; некорректные значения отклоняются
+    BulkResult bulkSetAttributes(vector<int> ids, const PipeAttributes& attributes, BulkMode mode = BulkMode::BestEffort) {
+        ScopedTimer timer("PipeManager::bulkSetAttributes");
+        bool valid = (!attributes.length || *attributes.length >= 0.01) &&
+                     (!attributes.diameter || *attributes.diameter >= 1);
+        return applyBulk("изменение атрибутов труб", move(ids), mode,
+                         [valid](const Pipe&) { return valid; },
+                         [&attributes](Pipe& pipe) {
+                             if (attributes.name) pipe.setName(*attributes.name);
+                             if (attributes.length) pipe.setLength(*attributes.length);
+                             if (attributes.diameter) pipe.setDiameter(*attributes.diameter);
+                             if (attributes.underRepair) pipe.setUnderRepair(*attributes.underRepair);
+                         }, attributes.name.has_value());
+    }
+    
+    void loadObjects(const map<int, Pipe>& newObjects) {
+        MemoryScope scope(MemorySubsystem::Objects);
+        objects = newObjects;
+        resetLoadedState();
+    }
+    
+    void loadObjects(map<int, Pipe>&& newObjects) {
+        MemoryScope scope(MemorySubsystem::Objects);
+        objects = move(newObjects);
+        resetLoadedState();
+    }
+};
+
+struct StationAttributes {
+    optional<string> name;
+    optional<int> totalWorkshops;
+    optional<string> classification;
+};
+
+// Менеджер для станций
+class StationManager : public BaseManager<CompressorStation> {
+public:
+    void addObject() override {
+        CompressorStation station;
+        station.readFromConsole(nextId);
+        MemoryScope scope(MemorySubsystem::Objects);
+        objects[nextId] = station;
+        nameIndex.add(nextId, station.getName());
+        markChanged(nextId);
+        nextId++;
+        cout << "Компрессорная станция создана с ID: " << (nextId - 1) << "\n";
+    }
+    
+    void addObject(const CompressorStation& station) {
+        MemoryScope scope(MemorySubsystem::Objects);
+        objects[station.getId()] = station;
+        nameIndex.add(station.getId(), station.getName());
+        markChanged(station.getId());
+        if (station.getId() >= nextId) {
+            nextId = station.getId() + 1;
+        }
+    }
+    
+    void editStationWorkshops(int id, int action) {
+        auto station = getObject(id);
+        if (station) {
+            bool success = (action == 1) ? station->startWorkshop() : station->stopWorkshop();
+            if (success) markChanged(id);
+            if (!success) cout << (action == 1 ? "Все цехи уже работают!\n" : "Нет работающих цехов!\n");
+        } else {
+            cout << "Станция с ID=" << id << " не найдена!\n";
+        }
+    }
+    
+    // В атомарном режиме каждая станция должна принять все count цехов,
+    // иначе запускается столько, сколько возможно
+    BulkResult bulkStartWorkshops(vector<int> ids, int count, BulkMode mode = BulkMode::BestEffort) {
+        ScopedTimer timer("StationManager::bulkStartWorkshops");
+        return applyBulk("запуск цехов: " + to_string(count), move(ids), mode,
+                         [count, mode](const CompressorStation& station) {
+                             int idle = station.getTotalWorkshops() - station.getWorkingWorkshops();
+                             return count > 0 && (mode == BulkMode::Atomic ? idle >= count : idle > 0);
+                         },
+                         [count](CompressorStation& station) {
+                             station.setWorkingWorkshops(min(station.getTotalWorkshops(), station.getWorkingWorkshops() + count));
+                         });
+    }
+    
+    BulkResult bulkStopWorkshops(vector<int> ids, int count, BulkMode mode = BulkMode::BestEffort) {
+        ScopedTimer timer("StationManager::bulkStopWorkshops");
+        return applyBulk("остановка цехов: " + to_string(count), move(ids), mode,
+                         [count, mode](const CompressorStation& station) {
+                             int working = station.getWorkingWorkshops();
+                             return count > 0 && (mode == BulkMode::Atomic ? working >= count : working > 0);
+                         },
+                         [count](CompressorStation& station) {
+                             station.setWorkingWorkshops(max(0, station.getWorkingWorkshops() - count));
+                         });
+    }
+    
+    BulkResult bulkSetAttributes(vector<int> ids, const StationAttributes& attributes, BulkMode mode = BulkMode::BestEffort) {
+        ScopedTimer timer("StationManager::bulkSetAttributes");
+        return applyBulk("изменение атрибутов станций", move(ids), mode,
+                         [&attributes](const CompressorStation& station) {
+                             return !attributes.totalWorkshops || (*attributes.totalWorkshops >= 1 &&
+                                    *attributes.totalWorkshops >= station.getWorkingWorkshops());
+                         },
+                         [&attributes](CompressorStation& station) {
+                             if (attributes.name) station.setName(*attributes.name);
+                             if (attributes.totalWorkshops) station.setTotalWorkshops(*attributes.totalWorkshops);
+                             if (attributes.classification) station.setClassification(*attributes.classification);
+                         }, attributes.name.has_value());
+    }
+    
+    set<int> findStationsByName(const string& nameFilter) const {
+        ScopedTimer timer("StationManager::findStationsByName");
+        return findObjects([&](const CompressorStation& station) { return station.matchesNameFilter(nameFilter); });
+    }
+    
+    set<int> findStationsByUnusedPercentage(double minPercentage) const {
+        ScopedTimer timer("StationManager::findStationsByUnusedPercentage");
+        return findObjects([&](const CompressorStation& station) { return station.matchesUnusedPercentageFilter(minPercentage); });
+    }
+    
+    void loadObjects(const map<int, CompressorStation>& newObjects) {
+        MemoryScope scope(MemorySubsystem::Objects);
+        objects = newObjects;
+        resetLoadedState();
+    }
+    
+    void loadObjects(map<int, CompressorStation>&& newObjects) {
+        MemoryScope scope(MemorySubsystem::Objects);
+        objects = move(newObjects);
+        resetLoadedState();
+    }
+};
+
+// Отдельные функции сохранения для каждого типа
+// Диапазон [begin, end) из count записей (используется и для шардов)
+template<typename Iterator>
+void savePipes(ostream& file, Iterator begin, Iterator end, size_t count) {
+    ScopedTimer timer("savePipes");
+    file << "Pipes:" << count << "\n";
+    for (auto it = begin; it != end; ++it) {
+        const Pipe& pipe = it->second;
+        file << pipe.getId() << "\n" << pipe.getName() << "\n"
+             << pipe.getLength() << "\n" << pipe.getDiameter() << "\n" << pipe.isUnderRepair() << "\n";
+    }
+}
+
+void savePipes(ostream& file, const map<int, Pipe>& pipes) {
+    savePipes(file, pipes.begin(), pipes.end(), pipes.size());
+}
+
+template<typename Iterator>
+void saveStations(ostream& file, Iterator begin, Iterator end, size_t count) {
+    ScopedTimer timer("saveStations");
+    file << "Stations:" << count << "\n";
+    for (auto it = begin; it != end; ++it) {
+        const CompressorStation& station = it->second;
+        file << station.getId() << "\n" << station.getName() << "\n"
+             << station.getTotalWorkshops() << "\n" << station.getWorkingWorkshops() << "\n" << station.getClassification() << "\n";
+    }
+}
+
+void saveStations(ostream& file, const map<int, CompressorStation>& stations) {
+    saveStations(file, stations.begin(), stations.end(), stations.size());
+}
+
+// Отдельные функции загрузки для каждого типа
+// Чтение одной записи; записи файла обрабатываются потоково
+void readPipe(istream& file, Pipe& pipe) {
+    string line;
+    getline(file, line); pipe.setId(stoi(line));
+    getline(file, line); pipe.setName(line);
+    getline(file, line); pipe.setLength(stod(line));
+    getline(file, line); pipe.setDiameter(stoi(line));
+    getline(file, line); pipe.setUnderRepair(stoi(line));
+}
+
+void readStation(istream& file, CompressorStation& station) {
+    string line;
+    getline(file, line); station.setId(stoi(line));
+    getline(file, line); station.setName(line);
+    getline(file, line); station.setTotalWorkshops(stoi(line));
+    getline(file, line); station.setWorkingWorkshops(stoi(line));
+    getline(file, line); station.setClassification(line);
+}
+
+void loadPipes(istream& file, map<int, Pipe>& pipes) {
+    ScopedTimer timer("loadPipes");
+    string line;
+    getline(file, line);
+    if (line.find("Pipes:") != string::npos) {
+        int count = stoi(line.substr(6));
+        for (int i = 0; i < count; i++) {
+            Pipe pipe;
+            readPipe(file, pipe);
+            // Узлы словаря переходят в менеджер и учитываются как объекты, а не буферы чтения
+            MemoryScope scope(MemorySubsystem::Objects);
+            pipes[pipe.getId()] = pipe;
+        }
+    }
+}
+
+void loadStations(istream& file, map<int, CompressorStation>& stations) {
+    ScopedTimer timer("loadStations");
+    string line;
+    getline(file, line);
+    if (line.find("Stations:") != string::npos) {
+        int count = stoi(line.substr(9));
+        for (int i = 0; i < count; i++) {
+            CompressorStation station;
+            readStation(file, station);
+            MemoryScope scope(MemorySubsystem::Objects);
+            stations[station.getId()] = station;
+        }
+    }
+}
+
+void saveToFile(const PipeManager& pipeManager, const StationManager& stationManager, const string& filename) {
+    ScopedTimer timer("saveToFile");
+    MemoryScope memoryScope(MemorySubsystem::IoBuffers);
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cout << "Ошибка создания файла!\n";
+        return;
+    }
+    
+    savePipes(file, pipeManager.getObjects());
+    saveStations(file, stationManager.getObjects());
+    
+    file.close();
+    logger.log("Данные сохранены в файл: " + filename);
+    cout << "Данные сохранены в файл: " << filename << "\n";
+}
+
+void loadFromFile(PipeManager& pipeManager, StationManager& stationManager, const string& filename) {
+    ScopedTimer timer("loadFromFile");
+    MemoryScope memoryScope(MemorySubsystem::IoBuffers);
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cout << "Ошибка открытия файла!\n";
+        return;
+    }
+    
+    map<int, Pipe> loadedPipes;
+    map<int, CompressorStation> loadedStations;
+    
+    loadPipes(file, loadedPipes);
+    loadStations(file, loadedStations);
+    
+    file.close();
+    
+    pipeManager.loadObjects(move(loadedPipes));
+    stationManager.loadObjects(move(loadedStations));
+    
+    logger.log("Данные загружены из файла: " + filename);
+    cout << "Данные загружены из файла: " << filename << "\n";
+    cout << "Загружено труб: " << pipeManager.getObjectCount() << ", станций: " << stationManager.getObjectCount() << "\n";
+}
+
+void printMergeSummary(const string& title, const MergeSummary& summary) {
+    cout << title << ": добавлено " << summary.inserted << ", обновлено " << summary.updated
+         << ", удалено " << summary.deleted << ", без изменений " << summary.unchanged
+         << ", конфликтов " << summary.conflicts << "\n";
+}
+
+// Инкрементальная загрузка: файл читается потоково и сравнивается с текущими
+// данными по ID; применяются только вставки, обновления и (по запросу) удаления.
+// При ошибке чтения данные не меняются
+void mergeFromFile(PipeManager& pipeManager, StationManager& stationManager, const string& filename,
+                   MergePolicy policy, bool deleteMissing) {
+    ScopedTimer timer("mergeFromFile");
+    MemoryScope memoryScope(MemorySubsystem::IoBuffers);
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cout << "Ошибка открытия файла!\n";
+        return;
+    }
+    
+    MergePlan<Pipe> pipePlan;
+    MergePlan<CompressorStation> stationPlan;
+    pipePlan.trackSeen = stationPlan.trackSeen = deleteMissing;
+    try {
+        string line;
+        getline(file, line);
+        if (line.find("Pipes:") != string::npos) {
+            int count = stoi(line.substr(6));
+            for (int i = 0; i < count; i++) {
+                Pipe pipe;
+                readPipe(file, pipe);
+                pipeManager.planMerge(pipe, policy, pipePlan);
+            }
+        }
+        getline(file, line);
+        if (line.find("Stations:") != string::npos) {
+            int count = stoi(line.substr(9));
+            for (int i = 0; i < count; i++) {
+                CompressorStation station;
+                readStation(file, station);
+                stationManager.planMerge(station, policy, stationPlan);
+            }
+        }
+    } catch (const exception&) {
+        cout << "Ошибка чтения файла! Данные не изменены.\n";
+        return;
+    }
+    
+    if (deleteMissing) {
+        pipeManager.planDeletes(policy, pipePlan);
+        stationManager.planDeletes(policy, stationPlan);
+    }
+    pipeManager.applyMerge(pipePlan);
+    stationManager.applyMerge(stationPlan);
+    
+    const MergeSummary& pipes = pipePlan.summary;
+    const MergeSummary& stations = stationPlan.summary;
+    logger.log("Слияние с файлом " + filename + ": труб +" + to_string(pipes.inserted) + " ~" +
+               to_string(pipes.updated) + " -" + to_string(pipes.deleted) + ", станций +" +
+               to_string(stations.inserted) + " ~" + to_string(stations.updated) + " -" +
+               to_string(stations.deleted) + ", конфликтов " + to_string(pipes.conflicts + stations.conflicts));
+    printMergeSummary("Трубы", pipes);
+    printMergeSummary("Станции", stations);
+}
+
+// Сохранение в шарды: объекты делятся на диапазоны ID, шарды сериализуются
+// параллельно, последним записывается манифест с контрольными суммами.
+// Манифест заменяется переименованием, поэтому сбой посреди сохранения
+// оставляет предыдущее поколение целым
+struct ShardInfo {
+    string file;
+    size_t bytes;
+    uint64_t checksum;
+};
+
+struct ShardManifest {
+    uint64_t generation = 0;
+    vector<ShardInfo> shards;
+};
+
+uint64_t checksum64(const string& data) {
+    return fnv1a(data.data(), data.size());
+}
+
+// Постоянный пул потоков: потоки создаются при первой потребности и живут до
+// выхода из программы, поэтому буферы профилировщика и номера потоков в трассе
+// не множатся от сохранения к сохранению. Задания выполняются по одному
+class WorkerPool {
+private:
+    mutex jobMutex;          // одно задание за раз
+    mutex stateMutex;
+    condition_variable wake;
+    condition_variable finished;
+    vector<thread> threads;
+    
+    const function<void(size_t)>* task;
+    size_t count;
+    atomic<size_t> next;
+    uint64_t generation;
+    size_t wanted;           // сколько потоков пула участвует в текущем задании
+    size_t joined;
+    size_t running;
+    bool stopping;
+    exception_ptr failure;
+    
+    void drain() {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                (*task)(i);
+            } catch (...) {
+                lock_guard<mutex> lock(stateMutex);
+                if (!failure) failure = current_exception();
+            }
+        }
+    }
+    
+    void workerLoop() {
+        uint64_t seen = 0;
+        unique_lock<mutex> lock(stateMutex);
+        while (true) {
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (joined == wanted) continue;
+            joined++;
+            lock.unlock();
+            drain();
+            lock.lock();
+            if (--running == 0) finished.notify_all();
+        }
+    }
+    
+public:
+    WorkerPool() : task(nullptr), count(0), next(0), generation(0), wanted(0), joined(0), running(0), stopping(false) {}
+    
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> lock(stateMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (thread& th : threads) th.join();
+    }
+    
+    // Выполняет job(i) для i из [0, itemCount) в вызывающем потоке и helpers потоках пула;
+    // первое исключение из job пробрасывается вызывающему после завершения всех потоков
+    void run(size_t itemCount, size_t helpers, const function<void(size_t)>& job) {
+        lock_guard<mutex> jobLock(jobMutex);
+        {
+            lock_guard<mutex> lock(stateMutex);
+            while (threads.size() < helpers) threads.emplace_back([this]() { workerLoop(); });
+            task = &job;
+            count = itemCount;
+            next = 0;
+            wanted = running = helpers;
+            joined = 0;
+            failure = nullptr;
+            generation++;
+        }
+        wake.notify_all();
+        drain();
+        
+        exception_ptr error;
+        {
+            unique_lock<mutex> lock(stateMutex);
+            finished.wait(lock, [&]() { return running == 0; });
+            task = nullptr;
+            error = failure;
+        }
+        if (error) rethrow_exception(error);
+    }
+};
+
+WorkerPool& workerPool() {
+    static WorkerPool pool;
+    return pool;
+}
+
+// Выполняет task(i) для i из [0, count) на пуле из threadCount потоков (включая вызывающий)
+template<typename Task>
+void parallelFor(size_t count, size_t threadCount, Task task) {
+    if (count == 0) return;
+    size_t helpers = min(threadCount, count);
+    workerPool().run(count, helpers ? helpers - 1 : 0, function<void(size_t)>(ref(task)));
+}
+
+size_t defaultShardCount() {
+    return max(1u, thread::hardware_concurrency());
+}
+
+string directoryOf(const string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == string::npos ? "" : path.substr(0, slash + 1);
+}
+
+// Запись одним вызовом с принудительным сбросом на диск (где это доступно)
+bool writeFileDurably(const string& path, const string& data) {
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = write(fd, data.data() + written, data.size() - written);
+        if (result < 0) {
+            close(fd);
+            return false;
+        }
+        written += result;
+    }
+    bool synced = fsync(fd) == 0;
+    return close(fd) == 0 && synced;
+#else
+    ofstream file(path, ios::binary);
+    file.write(data.data(), data.size());
+    file.close();
+    return !file.fail();
+#endif
+}
+
+void syncDirectory(const string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+    string directory = directoryOf(path);
+    int fd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+bool readManifest(const string& path, ShardManifest& manifest) {
+    ifstream file(path);
+    string line;
+    if (!getline(file, line) || line != "Manifest:1") return false;
+    try {
+        getline(file, line); manifest.generation = stoull(line.substr(line.find(':') + 1));
+        getline(file, line); size_t count = stoul(line.substr(line.find(':') + 1));
+        manifest.shards.clear();
+        for (size_t i = 0; i < count; i++) {
+            ShardInfo shard;
+            getline(file, shard.file);
+            getline(file, line); shard.bytes = stoull(line);
+            getline(file, line); shard.checksum = stoull(line, nullptr, 16);
+            manifest.shards.push_back(shard);
+        }
+    } catch (const exception&) {
+        return false;
+    }
+    return !file.fail();
+}
+
+// Границы count равных по числу объектов диапазонов ID
+template<typename T>
+vector<typename map<int, T>::const_iterator> shardBoundaries(const map<int, T>& objects, size_t count) {
+    vector<typename map<int, T>::const_iterator> bounds;
+    auto it = objects.begin();
+    for (size_t i = 0; i < count; i++) {
+        bounds.push_back(it);
+        size_t step = objects.size() * (i + 1) / count - objects.size() * i / count;
+        advance(it, step);
+    }
+    bounds.push_back(objects.end());
+    return bounds;
+}
+
+void saveToShards(const PipeManager& pipeManager, const StationManager& stationManager,
+                  const string& manifestPath, size_t shardCount = defaultShardCount()) {
+    ScopedTimer timer("saveToShards");
+    MemoryScope memoryScope(MemorySubsystem::IoBuffers);
+    ShardManifest previous;
+    bool hasPrevious = readManifest(manifestPath, previous);
+    
+    ShardManifest manifest;
+    manifest.generation = previous.generation + 1;
+    manifest.shards.resize(shardCount);
+    
+    const map<int, Pipe>& pipes = pipeManager.getObjects();
+    const map<int, CompressorStation>& stations = stationManager.getObjects();
+    auto pipeBounds = shardBoundaries(pipes, shardCount);
+    auto stationBounds = shardBoundaries(stations, shardCount);
+    string directory = directoryOf(manifestPath);
+    string baseName = manifestPath.substr(directory.size());
+    for (size_t i = 0; i < shardCount; i++) {
+        manifest.shards[i].file = baseName + ".g" + to_string(manifest.generation) + ".s" + to_string(i);
+    }
+    // При любой ошибке файлы нового поколения удаляются: без манифеста они не нужны
+    auto discardShards = [&]() {
+        for (const ShardInfo& shard : manifest.shards) remove((directory + shard.file).c_str());
+    };
+    
+    // Исключения (например, bad_alloc при сборке буфера) перехватываются в задаче
+    // и считаются ошибкой записи шарда
+    vector<char> failed(shardCount, 0);
+    parallelFor(shardCount, shardCount, [&](size_t i) {
+        ScopedTimer shardTimer("saveToShards.shard");
+        MemoryScope memoryScope(MemorySubsystem::IoBuffers);
+        try {
+            ostringstream buffer;
+            savePipes(buffer, pipeBounds[i], pipeBounds[i + 1], distance(pipeBounds[i], pipeBounds[i + 1]));
+            saveStations(buffer, stationBounds[i], stationBounds[i + 1], distance(stationBounds[i], stationBounds[i + 1]));
+            string data = buffer.str();
+            
+            ShardInfo& shard = manifest.shards[i];
+            shard.bytes = data.size();
+            shard.checksum = checksum64(data);
+            failed[i] = !writeFileDurably(directory + shard.file, data);
+        } catch (const exception&) {
+            failed[i] = 1;
+        }
+    });
+    
+    if (find(failed.begin(), failed.end(), 1) != failed.end()) {
+        discardShards();
+        cout << "Ошибка записи шардов! Предыдущее сохранение не изменено.\n";
+        return;
+    }
+    
+    ostringstream text;
+    text << "Manifest:1\nGeneration:" << manifest.generation << "\nShards:" << shardCount << "\n";
+    for (const ShardInfo& shard : manifest.shards) {
+        text << shard.file << "\n" << shard.bytes << "\n" << hex << shard.checksum << dec << "\n";
+    }
+    string temporary = manifestPath + ".tmp";
+    if (!writeFileDurably(temporary, text.str()) || rename(temporary.c_str(), manifestPath.c_str()) != 0) {
+        remove(temporary.c_str());
+        discardShards();
+        cout << "Ошибка записи манифеста! Предыдущее сохранение не изменено.\n";
+        return;
+    }
+    syncDirectory(manifestPath);
+    
+    if (hasPrevious) {
+        for (const ShardInfo& shard : previous.shards) remove((directory + shard.file).c_str());
+    }
+    
+    logger.log("Данные сохранены в шарды: " + manifestPath + " (поколение " + to_string(manifest.generation) +
+               ", шардов " + to_string(shardCount) + ")");
+    cout << "Данные сохранены: " << shardCount << " шардов, манифест " << manifestPath << "\n";
+}
+
+void loadFromShards(PipeManager& pipeManager, StationManager& stationManager, const string& manifestPath) {
+    ScopedTimer timer("loadFromShards");
+    MemoryScope memoryScope(MemorySubsystem::IoBuffers);
+    ShardManifest manifest;
+    if (!readManifest(manifestPath, manifest)) {
+        cout << "Ошибка чтения манифеста!\n";
+        return;
+    }
+    
+    size_t shardCount = manifest.shards.size();
+    vector<map<int, Pipe>> shardPipes(shardCount);
+    vector<map<int, CompressorStation>> shardStations(shardCount);
+    vector<string> errors(shardCount);
+    string directory = directoryOf(manifestPath);
+    
+    parallelFor(shardCount, defaultShardCount(), [&](size_t i) {
+        ScopedTimer shardTimer("loadFromShards.shard");
+        MemoryScope memoryScope(MemorySubsystem::IoBuffers);
+        const ShardInfo& shard = manifest.shards[i];
+        ifstream file(directory + shard.file, ios::binary);
+        // Размер из манифеста сверяется с файлом до выделения буфера
+        streamoff fileSize = file.seekg(0, ios::end) ? static_cast<streamoff>(file.tellg()) : -1;
+        if (fileSize < 0 || static_cast<uint64_t>(fileSize) != shard.bytes) {
+            errors[i] = "размер не совпадает";
+            return;
+        }
+        file.seekg(0);
+        try {
+            string data(shard.bytes, '\0');
+            if (!file.read(&data[0], data.size())) {
+                errors[i] = "размер не совпадает";
+            } else if (checksum64(data) != shard.checksum) {
+                errors[i] = "контрольная сумма не совпадает";
+            } else {
+                istringstream buffer(data);
+                loadPipes(buffer, shardPipes[i]);
+                loadStations(buffer, shardStations[i]);
+            }
+        } catch (const exception&) {
+            errors[i] = "неверный формат";
+        }
+    });
+    
+    for (size_t i = 0; i < shardCount; i++) {
+        if (!errors[i].empty()) {
+            cout << "Ошибка шарда " << manifest.shards[i].file << ": " << errors[i] << "\n";
+            return;
+        }
+    }
+    
+    // Шарды содержат непересекающиеся возрастающие диапазоны ID: узлы переносятся
+    // в конец общего словаря без копирования объектов
+    map<int, Pipe> loadedPipes;
+    map<int, CompressorStation> loadedStations;
+    for (size_t i = 0; i < shardCount; i++) {
+        while (!shardPipes[i].empty()) loadedPipes.insert(loadedPipes.end(), shardPipes[i].extract(shardPipes[i].begin()));
+        while (!shardStations[i].empty()) {
+            loadedStations.insert(loadedStations.end(), shardStations[i].extract(shardStations[i].begin()));
+        }
+    }
+    
+    pipeManager.loadObjects(move(loadedPipes));
+    stationManager.loadObjects(move(loadedStations));
+    
+    logger.log("Данные загружены из шардов: " + manifestPath + " (поколение " + to_string(manifest.generation) + ")");
+    cout << "Загружено труб: " << pipeManager.getObjectCount() << ", станций: " << stationManager.getObjectCount() << "\n";
+}
+
+// Экспорт и импорт в формате Apache Arrow IPC (потоковый формат, .arrows)
+// Метаданные кодируются во FlatBuffers вручную, столбцы пишутся пакетами
+// непосредственно из буферов без построчного форматирования
+const size_t ARROW_BATCH_ROWS = 65536;
+
+enum ArrowType : uint8_t {
+    ARROW_INT = 2,
+    ARROW_FLOAT = 3,
+    ARROW_UTF8 = 5,
+    ARROW_BOOL = 6,
+    ARROW_LARGE_UTF8 = 20
+};
+
+struct ArrowField {
+    string name;
+    uint8_t type;
+    int bitWidth;
+};
+
+// Минимальный построитель FlatBuffers: объекты пишутся от начала к концу,
+// смещения на дочерние объекты дописываются после их создания
+class FlatBufferBuilder {
+private:
+    vector<uint8_t> buf;
+    
+public:
+    FlatBufferBuilder() : buf(4, 0) {}  // место под смещение корневой таблицы
+    
+    const vector<uint8_t>& data() const { return buf; }
+    
+    void pad(size_t alignment) {
+        while (buf.size() % alignment) buf.push_back(0);
+    }
+    
+    template<typename T>
+    void put(size_t pos, T value) {
+        memcpy(&buf[pos], &value, sizeof(T));
+    }
+    
+    void link(size_t pos, size_t target) {
+        put<uint32_t>(pos, static_cast<uint32_t>(target - pos));
+    }
+    
+    // Таблица с полями заданных размеров (0 - поле отсутствует), fieldPos - позиции полей
+    size_t addTable(const vector<size_t>& sizes, vector<size_t>& fieldPos) {
+        pad(2);
+        size_t vtable = buf.size();
+        size_t vtableSize = 4 + 2 * sizes.size();
+        buf.resize(vtable + vtableSize);
+        pad(8);
+        size_t start = buf.size();
+        
+        vector<size_t> order(sizes.size());
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+        
+        vector<size_t> offsets(sizes.size(), 0);
+        size_t tableSize = 4;
+        for (size_t i : order) {
+            if (sizes[i] == 0) continue;
+            tableSize = (tableSize + sizes[i] - 1) / sizes[i] * sizes[i];
+            offsets[i] = tableSize;
+            tableSize += sizes[i];
+        }
+        tableSize = (tableSize + 3) / 4 * 4;
+        buf.resize(start + tableSize);
+        
+        put<int32_t>(start, static_cast<int32_t>(start - vtable));
+        put<uint16_t>(vtable, static_cast<uint16_t>(vtableSize));
+        put<uint16_t>(vtable + 2, static_cast<uint16_t>(tableSize));
+        fieldPos.assign(sizes.size(), 0);
+        for (size_t i = 0; i < sizes.size(); i++) {
+            put<uint16_t>(vtable + 4 + 2 * i, static_cast<uint16_t>(offsets[i]));
+            if (offsets[i]) fieldPos[i] = start + offsets[i];
+        }
+        return start;
+    }
+    
+    size_t addString(const string& value) {
+        pad(4);
+        size_t pos = buf.size();
+        buf.resize(pos + 4);
+        put<uint32_t>(pos, static_cast<uint32_t>(value.size()));
+        buf.insert(buf.end(), value.begin(), value.end());
+        buf.push_back(0);
+        return pos;
+    }
+    
+    // Вектор смещений: элемент i находится по адресу pos + 4 + 4 * i
+    size_t addOffsetVector(size_t count) {
+        pad(4);
+        size_t pos = buf.size();
+        buf.resize(pos + 4 + 4 * count);
+        put<uint32_t>(pos, static_cast<uint32_t>(count));
+        return pos;
+    }
+    
+    // Вектор структур из двух int64 (FieldNode, Buffer)
+    size_t addStructVector(const vector<pair<int64_t, int64_t>>& items) {
+        while ((buf.size() + 4) % 8) buf.push_back(0);
+        size_t pos = buf.size();
+        buf.resize(pos + 4 + 16 * items.size());
+        put<uint32_t>(pos, static_cast<uint32_t>(items.size()));
+        for (size_t i = 0; i < items.size(); i++) {
+            put<int64_t>(pos + 4 + 16 * i, items[i].first);
+            put<int64_t>(pos + 12 + 16 * i, items[i].second);
+        }
+        return pos;
+    }
+    
+    void finish(size_t root) {
+        link(0, root);
+        pad(8);
+    }
+};
+
+// Чтение таблиц FlatBuffers с проверкой границ
+class FlatBufferTable {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    
+    void require(size_t at, size_t count) const {
+        if (at > size || count > size - at) {
+            throw runtime_error("повреждены метаданные Arrow");
+        }
+    }
+    
+    template<typename T>
+    T read(size_t at) const {
+        require(at, sizeof(T));
+        T value;
+        memcpy(&value, data + at, sizeof(T));
+        return value;
+    }
+    
+    size_t fieldPos(int slot) const {
+        int64_t vtable = static_cast<int64_t>(pos) - read<int32_t>(pos);
+        if (vtable < 0) throw runtime_error("повреждены метаданные Arrow");
+        uint16_t vtableSize = read<uint16_t>(vtable);
+        size_t entry = 4 + 2 * slot;
+        if (entry + 2 > vtableSize) return 0;
+        uint16_t offset = read<uint16_t>(vtable + entry);
+        return offset ? pos + offset : 0;
+    }
+    
+    size_t deref(size_t at) const {
+        return at + read<uint32_t>(at);
+    }
+    
+    FlatBufferTable(const uint8_t* data, size_t size, size_t pos) : data(data), size(size), pos(pos) {}
+    
+public:
+    FlatBufferTable() : data(nullptr), size(0), pos(0) {}
+    
+    static FlatBufferTable root(const vector<uint8_t>& buf) {
+        FlatBufferTable table(buf.data(), buf.size(), 0);
+        table.pos = table.deref(0);
+        return table;
+    }
+    
+    bool valid() const { return data != nullptr; }
+    
+    template<typename T>
+    T scalar(int slot, T defaultValue) const {
+        size_t at = fieldPos(slot);
+        return at ? read<T>(at) : defaultValue;
+    }
+    
+    FlatBufferTable table(int slot) const {
+        size_t at = fieldPos(slot);
+        return at ? FlatBufferTable(data, size, deref(at)) : FlatBufferTable();
+    }
+    
+    string str(int slot) const {
+        size_t at = fieldPos(slot);
+        if (!at) return "";
+        size_t start = deref(at);
+        uint32_t length = read<uint32_t>(start);
+        require(start + 4, length);
+        return string(reinterpret_cast<const char*>(data + start + 4), length);
+    }
+    
+    size_t vectorLength(int slot) const {
+        size_t at = fieldPos(slot);
+        return at ? read<uint32_t>(deref(at)) : 0;
+    }
+    
+    FlatBufferTable tableAt(int slot, size_t index) const {
+        size_t element = deref(fieldPos(slot)) + 4 + 4 * index;
+        return FlatBufferTable(data, size, deref(element));
+    }
+    
+    // Поле int64 структуры из двух int64 в векторе структур
+    int64_t structAt(int slot, size_t index, int member) const {
+        return read<int64_t>(deref(fieldPos(slot)) + 4 + 16 * index + 8 * member);
+    }
+};
+
+// Пакет записей: столбцы ссылаются на буферы вызывающего кода без копирования
+class ArrowRecordBatch {
+private:
+    int64_t rows;
+    vector<pair<int64_t, int64_t>> nodes;
+    vector<pair<const void*, size_t>> buffers;
+    
+public:
+    explicit ArrowRecordBatch(int64_t rows) : rows(rows) {}
+    
+    int64_t getRows() const { return rows; }
+    const vector<pair<int64_t, int64_t>>& getNodes() const { return nodes; }
+    const vector<pair<const void*, size_t>>& getBuffers() const { return buffers; }
+    
+    // Столбец фиксированной ширины (в том числе битовая маска bool)
+    void addColumn(const void* values, size_t bytes) {
+        nodes.push_back({rows, 0});
+        buffers.push_back({nullptr, 0});  // пустая маска валидности: значений null нет
+        buffers.push_back({values, bytes});
+    }
+    
+    void addStringColumn(const vector<int32_t>& offsets, const string& chars) {
+        nodes.push_back({rows, 0});
+        buffers.push_back({nullptr, 0});
+        buffers.push_back({offsets.data(), offsets.size() * sizeof(int32_t)});
+        buffers.push_back({chars.data(), chars.size()});
+    }
+};
+
+class ArrowStreamWriter {
+private:
+    ostream& out;
+    
+    void writeMessage(const FlatBufferBuilder& fb) {
+        const vector<uint8_t>& metadata = fb.data();
+        uint32_t continuation = 0xFFFFFFFF;
+        int32_t metadataSize = static_cast<int32_t>(metadata.size());
+        out.write(reinterpret_cast<const char*>(&continuation), 4);
+        out.write(reinterpret_cast<const char*>(&metadataSize), 4);
+        out.write(reinterpret_cast<const char*>(metadata.data()), metadata.size());
+    }
+    
+    // Таблица Message: version, header_type, header, bodyLength; возвращает позицию поля header
+    static size_t beginMessage(FlatBufferBuilder& fb, uint8_t headerType, int64_t bodyLength, size_t& message) {
+        vector<size_t> fields;
+        message = fb.addTable({2, 1, 4, 8}, fields);
+        fb.put<int16_t>(fields[0], 4);  // MetadataVersion::V5
+        fb.put<uint8_t>(fields[1], headerType);
+        fb.put<int64_t>(fields[3], bodyLength);
+        return fields[2];
+    }
+    
+public:
+    explicit ArrowStreamWriter(ostream& out) : out(out) {}
+    
+    void writeSchema(const vector<ArrowField>& columns) {
+        FlatBufferBuilder fb;
+        size_t message;
+        size_t header = beginMessage(fb, 1, 0, message);  // MessageHeader::Schema
+        
+        vector<size_t> schema;
+        fb.link(header, fb.addTable({2, 4}, schema));
+        fb.put<int16_t>(schema[0], 0);  // Endianness::Little
+        size_t fieldVector = fb.addOffsetVector(columns.size());
+        fb.link(schema[1], fieldVector);
+        
+        for (size_t i = 0; i < columns.size(); i++) {
+            vector<size_t> field;
+            fb.link(fieldVector + 4 + 4 * i, fb.addTable({4, 1, 1, 4, 0, 4}, field));
+            size_t name = fb.addString(columns[i].name);
+            fb.link(field[0], name);
+            fb.put<uint8_t>(field[1], 0);
+            fb.put<uint8_t>(field[2], columns[i].type);
+            
+            vector<size_t> type;
+            size_t typeTable;
+            if (columns[i].type == ARROW_INT) {
+                typeTable = fb.addTable({4, 1}, type);
+                fb.put<int32_t>(type[0], columns[i].bitWidth);
+                fb.put<uint8_t>(type[1], 1);
+            } else if (columns[i].type == ARROW_FLOAT) {
+                typeTable = fb.addTable({2}, type);
+                fb.put<int16_t>(type[0], 2);  // Precision::DOUBLE
+            } else {
+                typeTable = fb.addTable({}, type);
+            }
+            fb.link(field[3], typeTable);
+            size_t children = fb.addOffsetVector(0);
+            fb.link(field[5], children);
+        }
+        
+        fb.finish(message);
+        writeMessage(fb);
+    }
+    
+    void writeBatch(const ArrowRecordBatch& batch) {
+        vector<pair<int64_t, int64_t>> layout;
+        int64_t bodyLength = 0;
+        for (const auto& buffer : batch.getBuffers()) {
+            layout.push_back({bodyLength, static_cast<int64_t>(buffer.second)});
+            bodyLength += (buffer.second + 7) / 8 * 8;
+        }
+        
+        FlatBufferBuilder fb;
+        size_t message;
+        size_t header = beginMessage(fb, 3, bodyLength, message);  // MessageHeader::RecordBatch
+        vector<size_t> recordBatch;
+        fb.link(header, fb.addTable({8, 4, 4}, recordBatch));
+        fb.put<int64_t>(recordBatch[0], batch.getRows());
+        size_t nodes = fb.addStructVector(batch.getNodes());
+        fb.link(recordBatch[1], nodes);
+        size_t buffers = fb.addStructVector(layout);
+        fb.link(recordBatch[2], buffers);
+        fb.finish(message);
+        writeMessage(fb);
+        
+        static const char padding[8] = {};
+        for (const auto& buffer : batch.getBuffers()) {
+            if (buffer.second) out.write(static_cast<const char*>(buffer.first), buffer.second);
+            out.write(padding, (8 - buffer.second % 8) % 8);
+        }
+    }
+    
+    void finish() {
+        uint32_t endOfStream[2] = {0xFFFFFFFF, 0};
+        out.write(reinterpret_cast<const char*>(endOfStream), sizeof(endOfStream));
+    }
+};
+
+// Представление столбца внутри тела прочитанного пакета
+class ArrowColumnView {
+private:
+    ArrowField field;
+    const uint8_t* validity;
+    const uint8_t* values;
+    const uint8_t* chars;
+    size_t charsSize;
+    
+    template<typename T>
+    T load(const uint8_t* base, int64_t index) const {
+        T value;
+        memcpy(&value, base + index * sizeof(T), sizeof(T));
+        return value;
+    }
+    
+public:
+    ArrowColumnView() : validity(nullptr), values(nullptr), chars(nullptr), charsSize(0) {}
+    ArrowColumnView(const ArrowField& field, const uint8_t* validity,
+                    const uint8_t* values, const uint8_t* chars, size_t charsSize)
+        : field(field), validity(validity), values(values), chars(chars), charsSize(charsSize) {}
+    
+    bool isNull(int64_t row) const {
+        return validity && !(validity[row / 8] & (1 << (row % 8)));
+    }
+    
+    int64_t getInt(int64_t row) const {
+        if (isNull(row)) return 0;
+        if (field.type == ARROW_INT) {
+            switch (field.bitWidth) {
+                case 8: return load<int8_t>(values, row);
+                case 16: return load<int16_t>(values, row);
+                case 32: return load<int32_t>(values, row);
+                case 64: return load<int64_t>(values, row);
+            }
+        }
+        if (field.type == ARROW_BOOL) return getBool(row);
+        throw runtime_error("столбец " + field.name + " не является целочисленным");
+    }
+    
+    double getDouble(int64_t row) const {
+        if (isNull(row)) return 0;
+        if (field.type == ARROW_FLOAT) return load<double>(values, row);
+        return static_cast<double>(getInt(row));
+    }
+    
+    bool getBool(int64_t row) const {
+        if (isNull(row)) return false;
+        if (field.type == ARROW_BOOL) return values[row / 8] & (1 << (row % 8));
+        return getInt(row) != 0;
+    }
+    
+    string getString(int64_t row) const {
+        if (isNull(row)) return "";
+        if (field.type != ARROW_UTF8 && field.type != ARROW_LARGE_UTF8) {
+            throw runtime_error("столбец " + field.name + " не является строковым");
+        }
+        int64_t begin = field.type == ARROW_UTF8 ? load<int32_t>(values, row) : load<int64_t>(values, row);
+        int64_t end = field.type == ARROW_UTF8 ? load<int32_t>(values, row + 1) : load<int64_t>(values, row + 1);
+        if (begin < 0 || end < begin || static_cast<size_t>(end) > charsSize) {
+            throw runtime_error("некорректные смещения строк в столбце " + field.name);
+        }
+        return string(reinterpret_cast<const char*>(chars) + begin, end - begin);
+    }
+};
+
+class ArrowStreamReader {
+private:
+    istream& in;
+    vector<uint8_t> metadata;
+    vector<uint8_t> body;
+    vector<ArrowField> fields;
+    vector<ArrowColumnView> columns;
+    int64_t rows;
+    
+    // Сколько байт осталось в потоке; для потоков без позиционирования - без ограничения
+    int64_t remainingBytes() {
+        streampos position = in.tellg();
+        if (position == streampos(-1)) return numeric_limits<int64_t>::max();
+        in.seekg(0, ios::end);
+        streampos end = in.tellg();
+        in.seekg(position);
+        return end == streampos(-1) ? numeric_limits<int64_t>::max() : static_cast<int64_t>(end - position);
+    }
+    
+    // Читает очередное сообщение; false - конец потока
+    bool readMessage(FlatBufferTable& message) {
+        int32_t metadataSize = 0;
+        if (!in.read(reinterpret_cast<char*>(&metadataSize), 4)) return false;
+        if (metadataSize == -1 && !in.read(reinterpret_cast<char*>(&metadataSize), 4)) return false;
+        if (metadataSize == 0) return false;
+        if (metadataSize < 0 || metadataSize > remainingBytes()) {
+            throw runtime_error("некорректный размер метаданных");
+        }
+        
+        metadata.resize(metadataSize);
+        if (!in.read(reinterpret_cast<char*>(metadata.data()), metadataSize)) {
+            throw runtime_error("неожиданный конец файла");
+        }
+        message = FlatBufferTable::root(metadata);
+        
+        int64_t bodyLength = message.scalar<int64_t>(3, 0);
+        if (bodyLength < 0 || bodyLength > remainingBytes()) {
+            throw runtime_error("некорректная длина тела сообщения");
+        }
+        body.resize(bodyLength);
+        if (bodyLength && !in.read(reinterpret_cast<char*>(body.data()), bodyLength)) {
+            throw runtime_error("неожиданный конец файла");
+        }
+        return true;
     }
     
-    void addObject(const CompressorStation& station) {
-        objects[station.getId()] = station;
-        if (station.getId() >= nextId) {
-            nextId = station.getId() + 1;
+    // Буфер должен вмещать elements элементов по elementBytes байт; размеры сравниваются
+    // делением, чтобы поврежденные значения не переполняли произведение
+    const uint8_t* bodyBuffer(const FlatBufferTable& batch, size_t index, uint64_t elements,
+                              uint64_t elementBytes = 1) const {
+        if (index >= batch.vectorLength(2)) throw runtime_error("недостаточно буферов в пакете");
+        int64_t offset = batch.structAt(2, index, 0);
+        int64_t length = batch.structAt(2, index, 1);
+        if (offset < 0 || length < 0 || static_cast<uint64_t>(offset) > body.size() ||
+            static_cast<uint64_t>(length) > body.size() - offset) {
+            throw runtime_error("буфер выходит за пределы пакета");
         }
+        if (elements > static_cast<uint64_t>(length) / elementBytes) throw runtime_error("буфер столбца слишком мал");
+        return length ? body.data() + offset : nullptr;
     }
     
-    void editStationWorkshops(int id, int action) {
-        auto station = getObject(id);
-        if (station) {
-            bool success = (action == 1) ? station->startWorkshop() : station->stopWorkshop();
-            if (!success) cout << (action == 1 ? "Все цехи уже работают!\n" : "Нет работающих цехов!\n");
-        } else {
-            cout << "Станция с ID=" << id << " не найдена!\n";
+public:
+    explicit ArrowStreamReader(istream& in) : in(in), rows(0) {}
+    
+    void readSchema() {
+        FlatBufferTable message;
+        if (!readMessage(message) || message.scalar<uint8_t>(1, 0) != 1) {
+            throw runtime_error("поток не начинается со схемы");
+        }
+        FlatBufferTable schema = message.table(2);
+        for (size_t i = 0; i < schema.vectorLength(1); i++) {
+            FlatBufferTable field = schema.tableAt(1, i);
+            if (field.table(4).valid()) throw runtime_error("словарные столбцы не поддерживаются");
+            ArrowField column{field.str(0), field.scalar<uint8_t>(2, 0), 0};
+            if (column.type == ARROW_INT) column.bitWidth = field.table(3).scalar<int32_t>(0, 0);
+            if (column.type == ARROW_FLOAT && field.table(3).scalar<int16_t>(0, 0) != 2) {
+                throw runtime_error("столбец " + column.name + ": поддерживается только float64");
+            }
+            fields.push_back(column);
         }
     }
     
-    set<int> findStationsByName(const string& nameFilter) const {
-        return findObjects([&](const CompressorStation& station) { return station.matchesNameFilter(nameFilter); });
+    // Загружает следующий пакет записей; false - пакеты закончились
+    bool nextBatch() {
+        FlatBufferTable message;
+        while (readMessage(message)) {
+            uint8_t headerType = message.scalar<uint8_t>(1, 0);
+            if (headerType == 2) throw runtime_error("словарные пакеты не поддерживаются");
+            if (headerType != 3) continue;
+            
+            FlatBufferTable batch = message.table(2);
+            if (batch.table(3).valid()) throw runtime_error("сжатые пакеты не поддерживаются");
+            rows = batch.scalar<int64_t>(0, 0);
+            if (rows < 0 || batch.vectorLength(1) != fields.size()) {
+                throw runtime_error("пакет не соответствует схеме");
+            }
+            // Каждой строке нужен хотя бы бит в теле пакета
+            if (static_cast<uint64_t>(rows) / 8 > body.size()) throw runtime_error("число строк превышает размер пакета");
+            
+            columns.clear();
+            size_t buffer = 0;
+            for (size_t i = 0; i < fields.size(); i++) {
+                const ArrowField& field = fields[i];
+                bool hasNulls = batch.structAt(1, i, 1) > 0;
+                const uint8_t* validity = bodyBuffer(batch, buffer++, hasNulls ? (rows + 7) / 8 : 0);
+                if (!hasNulls) validity = nullptr;
+                
+                if (field.type == ARROW_UTF8 || field.type == ARROW_LARGE_UTF8) {
+                    size_t offsetWidth = field.type == ARROW_UTF8 ? 4 : 8;
+                    const uint8_t* offsets = bodyBuffer(batch, buffer++, rows ? rows + 1 : 0, offsetWidth);
+                    int64_t charsLength = batch.structAt(2, buffer, 1);
+                    const uint8_t* chars = bodyBuffer(batch, buffer++, 0);
+                    columns.emplace_back(field, validity, offsets, chars, charsLength);
+                } else {
+                    const uint8_t* values = nullptr;
+                    bool intWidth = field.bitWidth == 8 || field.bitWidth == 16 || field.bitWidth == 32 || field.bitWidth == 64;
+                    if (field.type == ARROW_BOOL) values = bodyBuffer(batch, buffer++, (rows + 7) / 8);
+                    else if (field.type == ARROW_FLOAT) values = bodyBuffer(batch, buffer++, rows, 8);
+                    else if (field.type == ARROW_INT && intWidth) values = bodyBuffer(batch, buffer++, rows, field.bitWidth / 8);
+                    else throw runtime_error("неподдерживаемый тип столбца " + field.name);
+                    columns.emplace_back(field, validity, values, nullptr, 0);
+                }
+            }
+            return true;
+        }
+        return false;
     }
     
-    set<int> findStationsByUnusedPercentage(double minPercentage) const {
-        return findObjects([&](const CompressorStation& station) { return station.matchesUnusedPercentageFilter(minPercentage); });
-    }
+    int64_t rowCount() const { return rows; }
     
-    void loadObjects(const map<int, CompressorStation>& newObjects) {
-        objects = newObjects;
-        updateNextId();
+    const ArrowColumnView& column(const string& name) const {
+        for (size_t i = 0; i < fields.size(); i++) {
+            if (fields[i].name == name) return columns[i];
+        }
+        throw runtime_error("отсутствует столбец " + name);
     }
 };
 
-// Отдельные функции сохранения для каждого типа
-void savePipes(ofstream& file, const map<int, Pipe>& pipes) {
-    file << "Pipes:" << pipes.size() << "\n";
-    for (const auto& entry : pipes) {
-        const Pipe& pipe = entry.second;
-        file << pipe.getId() << "\n" << pipe.getName() << "\n"
-             << pipe.getLength() << "\n" << pipe.getDiameter() << "\n" << pipe.isUnderRepair() << "\n";
+void writePipesArrow(ostream& out, const map<int, Pipe>& pipes, size_t batchRows) {
+    ArrowStreamWriter writer(out);
+    writer.writeSchema({{"id", ARROW_INT, 32}, {"name", ARROW_UTF8, 0}, {"length", ARROW_FLOAT, 64},
+                        {"diameter", ARROW_INT, 32}, {"underRepair", ARROW_BOOL, 0}});
+    
+    vector<int32_t> ids, nameOffsets, diameters;
+    vector<double> lengths;
+    vector<uint8_t> repairBits;
+    string names;
+    auto it = pipes.begin();
+    while (it != pipes.end()) {
+        ids.clear(); diameters.clear(); lengths.clear(); names.clear();
+        nameOffsets.assign(1, 0);
+        repairBits.assign((batchRows + 7) / 8, 0);
+        
+        size_t rows = 0;
+        for (; it != pipes.end() && rows < batchRows; ++it, ++rows) {
+            const Pipe& pipe = it->second;
+            ids.push_back(pipe.getId());
+            names += pipe.getName();
+            nameOffsets.push_back(static_cast<int32_t>(names.size()));
+            lengths.push_back(pipe.getLength());
+            diameters.push_back(pipe.getDiameter());
+            if (pipe.isUnderRepair()) repairBits[rows / 8] |= 1 << (rows % 8);
+        }
+        repairBits.resize((rows + 7) / 8);
+        
+        ArrowRecordBatch batch(rows);
+        batch.addColumn(ids.data(), ids.size() * sizeof(int32_t));
+        batch.addStringColumn(nameOffsets, names);
+        batch.addColumn(lengths.data(), lengths.size() * sizeof(double));
+        batch.addColumn(diameters.data(), diameters.size() * sizeof(int32_t));
+        batch.addColumn(repairBits.data(), repairBits.size());
+        writer.writeBatch(batch);
     }
+    writer.finish();
 }
 
-void saveStations(ofstream& file, const map<int, CompressorStation>& stations) {
-    file << "Stations:" << stations.size() << "\n";
-    for (const auto& entry : stations) {
-        const CompressorStation& station = entry.second;
-        file << station.getId() << "\n" << station.getName() << "\n"
-             << station.getTotalWorkshops() << "\n" << station.getWorkingWorkshops() << "\n" << station.getClassification() << "\n";
+void writeStationsArrow(ostream& out, const map<int, CompressorStation>& stations, size_t batchRows) {
+    ArrowStreamWriter writer(out);
+    writer.writeSchema({{"id", ARROW_INT, 32}, {"name", ARROW_UTF8, 0}, {"totalWorkshops", ARROW_INT, 32},
+                        {"workingWorkshops", ARROW_INT, 32}, {"classification", ARROW_UTF8, 0}});
+    
+    vector<int32_t> ids, nameOffsets, totals, working, classOffsets;
+    string names, classifications;
+    auto it = stations.begin();
+    while (it != stations.end()) {
+        ids.clear(); totals.clear(); working.clear(); names.clear(); classifications.clear();
+        nameOffsets.assign(1, 0);
+        classOffsets.assign(1, 0);
+        
+        size_t rows = 0;
+        for (; it != stations.end() && rows < batchRows; ++it, ++rows) {
+            const CompressorStation& station = it->second;
+            ids.push_back(station.getId());
+            names += station.getName();
+            nameOffsets.push_back(static_cast<int32_t>(names.size()));
+            totals.push_back(station.getTotalWorkshops());
+            working.push_back(station.getWorkingWorkshops());
+            classifications += station.getClassification();
+            classOffsets.push_back(static_cast<int32_t>(classifications.size()));
+        }
+        
+        ArrowRecordBatch batch(rows);
+        batch.addColumn(ids.data(), ids.size() * sizeof(int32_t));
+        batch.addStringColumn(nameOffsets, names);
+        batch.addColumn(totals.data(), totals.size() * sizeof(int32_t));
+        batch.addColumn(working.data(), working.size() * sizeof(int32_t));
+        batch.addStringColumn(classOffsets, classifications);
+        writer.writeBatch(batch);
     }
+    writer.finish();
 }
 
-// Отдельные функции загрузки для каждого типа
-void loadPipes(ifstream& file, map<int, Pipe>& pipes) {
-    string line;
-    getline(file, line);
-    if (line.find("Pipes:") != string::npos) {
-        int count = stoi(line.substr(6));
-        for (int i = 0; i < count; i++) {
-            getline(file, line);
-            int id = stoi(line);
+void readPipesArrow(istream& in, map<int, Pipe>& pipes) {
+    ArrowStreamReader reader(in);
+    reader.readSchema();
+    while (reader.nextBatch()) {
+        const ArrowColumnView& ids = reader.column("id");
+        const ArrowColumnView& names = reader.column("name");
+        const ArrowColumnView& lengths = reader.column("length");
+        const ArrowColumnView& diameters = reader.column("diameter");
+        const ArrowColumnView& repairs = reader.column("underRepair");
+        for (int64_t row = 0; row < reader.rowCount(); row++) {
             Pipe pipe;
-            pipe.setId(id);
-            
-            getline(file, line); pipe.setName(line);
-            getline(file, line); pipe.setLength(stod(line));
-            getline(file, line); pipe.setDiameter(stoi(line));
-            getline(file, line); pipe.setUnderRepair(stoi(line));
-            
-            pipes[id] = pipe;
+            pipe.setId(static_cast<int>(ids.getInt(row)));
+            pipe.setName(names.getString(row));
+            pipe.setLength(lengths.getDouble(row));
+            pipe.setDiameter(static_cast<int>(diameters.getInt(row)));
+            pipe.setUnderRepair(repairs.getBool(row));
+            MemoryScope scope(MemorySubsystem::Objects);
+            pipes[pipe.getId()] = pipe;
         }
     }
 }
 
-void loadStations(ifstream& file, map<int, CompressorStation>& stations) {
-    string line;
-    getline(file, line);
-    if (line.find("Stations:") != string::npos) {
-        int count = stoi(line.substr(9));
-        for (int i = 0; i < count; i++) {
-            getline(file, line);
-            int id = stoi(line);
+void readStationsArrow(istream& in, map<int, CompressorStation>& stations) {
+    ArrowStreamReader reader(in);
+    reader.readSchema();
+    while (reader.nextBatch()) {
+        const ArrowColumnView& ids = reader.column("id");
+        const ArrowColumnView& names = reader.column("name");
+        const ArrowColumnView& totals = reader.column("totalWorkshops");
+        const ArrowColumnView& working = reader.column("workingWorkshops");
+        const ArrowColumnView& classifications = reader.column("classification");
+        for (int64_t row = 0; row < reader.rowCount(); row++) {
             CompressorStation station;
-            station.setId(id);
-            
-            getline(file, line); station.setName(line);
-            getline(file, line); station.setTotalWorkshops(stoi(line));
-            getline(file, line); station.setWorkingWorkshops(stoi(line));
-            getline(file, line); station.setClassification(line);
-            
-            stations[id] = station;
+            station.setId(static_cast<int>(ids.getInt(row)));
+            station.setName(names.getString(row));
+            station.setTotalWorkshops(static_cast<int>(totals.getInt(row)));
+            station.setWorkingWorkshops(static_cast<int>(working.getInt(row)));
+            station.setClassification(classifications.getString(row));
+            MemoryScope scope(MemorySubsystem::Objects);
+            stations[station.getId()] = station;
         }
     }
 }
 
-void saveToFile(const PipeManager& pipeManager, const StationManager& stationManager, const string& filename) {
-    ofstream file(filename);
-    if (!file.is_open()) {
+// Экспорт в два потоковых файла Arrow: <имя>.pipes.arrows и <имя>.stations.arrows
+void exportToArrow(const PipeManager& pipeManager, const StationManager& stationManager,
+                   const string& baseName, size_t batchRows = ARROW_BATCH_ROWS) {
+    ScopedTimer timer("exportToArrow");
+    MemoryScope memoryScope(MemorySubsystem::IoBuffers);
+    ofstream pipesFile(baseName + ".pipes.arrows", ios::binary);
+    ofstream stationsFile(baseName + ".stations.arrows", ios::binary);
+    if (!pipesFile.is_open() || !stationsFile.is_open()) {
         cout << "Ошибка создания файла!\n";
         return;
     }
     
-    savePipes(file, pipeManager.getObjects());
-    saveStations(file, stationManager.getObjects());
+    writePipesArrow(pipesFile, pipeManager.getObjects(), batchRows);
+    writeStationsArrow(stationsFile, stationManager.getObjects(), batchRows);
     
-    file.close();
-    logger.log("Данные сохранены в файл: " + filename);
-    cout << "Данные сохранены в файл: " << filename << "\n";
+    pipesFile.close();
+    stationsFile.close();
+    logger.log("Данные экспортированы в Arrow: " + baseName);
+    cout << "Данные экспортированы в файлы " << baseName << ".pipes.arrows и " << baseName << ".stations.arrows\n";
 }
 
-void loadFromFile(PipeManager& pipeManager, StationManager& stationManager, const string& filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+void importFromArrow(PipeManager& pipeManager, StationManager& stationManager, const string& baseName) {
+    ScopedTimer timer("importFromArrow");
+    MemoryScope memoryScope(MemorySubsystem::IoBuffers);
+    ifstream pipesFile(baseName + ".pipes.arrows", ios::binary);
+    ifstream stationsFile(baseName + ".stations.arrows", ios::binary);
+    if (!pipesFile.is_open() || !stationsFile.is_open()) {
         cout << "Ошибка открытия файла!\n";
         return;
     }
     
     map<int, Pipe> loadedPipes;
     map<int, CompressorStation> loadedStations;
+    try {
+        readPipesArrow(pipesFile, loadedPipes);
+        readStationsArrow(stationsFile, loadedStations);
+    } catch (const exception& error) {
+        // Кроме ошибок формата сюда попадают bad_alloc/length_error на поврежденных размерах
+        cout << "Ошибка чтения Arrow: " << error.what() << "\n";
+        return;
+    }
     
-    loadPipes(file, loadedPipes);
-    loadStations(file, loadedStations);
+    pipeManager.loadObjects(move(loadedPipes));
+    stationManager.loadObjects(move(loadedStations));
     
-    file.close();
+    logger.log("Данные импортированы из Arrow: " + baseName);
+    cout << "Загружено труб: " << pipeManager.getObjectCount() << ", станций: " << stationManager.getObjectCount() << "\n";
+}
+
+// Детерминированный генератор синтетической сети
+class NetworkGenerator {
+private:
+    mt19937_64 rng;
     
-    pipeManager.loadObjects(loadedPipes);
-    stationManager.loadObjects(loadedStations);
+    // Собственные преобразования вместо std::*_distribution, чтобы результат
+    // не зависел от реализации стандартной библиотеки
+    size_t pick(size_t count) { return rng() % count; }
+    double uniform() { return (rng() >> 11) * (1.0 / 9007199254740992.0); }
     
-    logger.log("Данные загружены из файла: " + filename);
-    cout << "Данные загружены из файла: " << filename << "\n";
-    cout << "Загружено труб: " << loadedPipes.size() << ", станций: " << loadedStations.size() << "\n";
+    double normal() {
+        double u1 = uniform(), u2 = uniform();
+        if (u1 < 1e-300) u1 = 1e-300;
+        return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+    }
+    
+public:
+    explicit NetworkGenerator(uint64_t seed = 42) : rng(seed) {}
+    
+    Pipe makePipe(int id) {
+        static const vector<string> kinds = {"Магистраль", "Отвод", "Лупинг", "Перемычка", "Коллектор"};
+        static const vector<string> routes = {"Уренгой-Помары", "Ямбург-Тула", "Сила Сибири", "Северный поток",
+                                              "Союз", "Прогресс", "Бованенково-Ухта", "Голубой поток"};
+        // Распределение типовых диаметров магистральных газопроводов
+        static const vector<pair<int, int>> diameters = {{530, 15}, {720, 20}, {820, 15}, {1020, 20}, {1220, 15}, {1420, 15}};
+        
+        Pipe pipe;
+        pipe.setId(id);
+        pipe.setName(kinds[pick(kinds.size())] + " " + routes[pick(routes.size())] + " " + to_string(pick(1000)));
+        
+        // Логнормальная длина с медианой 20 км
+        double length = exp(log(20.0) + normal());
+        pipe.setLength(round(min(max(length, 0.1), 500.0) * 100) / 100);
+        
+        int weight = static_cast<int>(pick(100));
+        for (const auto& entry : diameters) {
+            if ((weight -= entry.second) < 0) {
+                pipe.setDiameter(entry.first);
+                break;
+            }
+        }
+        pipe.setUnderRepair(uniform() < 0.05);
+        return pipe;
+    }
+    
+    CompressorStation makeStation(int id) {
+        static const vector<string> cities = {"Ухта", "Торжок", "Грязовец", "Сосногорск", "Пангоды",
+                                              "Ямбург", "Надым", "Вуктыл", "Починки", "Моршанск"};
+        static const vector<string> classes = {"Головная", "Линейная", "Дожимная", "Магистральная"};
+        
+        CompressorStation station;
+        station.setId(id);
+        station.setName("КС " + cities[pick(cities.size())] + "-" + to_string(pick(100)));
+        int total = 1 + static_cast<int>(pick(12));
+        station.setTotalWorkshops(total);
+        station.setWorkingWorkshops(static_cast<int>(pick(total + 1)));
+        station.setClassification(classes[pick(classes.size())]);
+        return station;
+    }
+};
+
+// Поток вывода, отбрасывающий все данные (подавляет сообщения в консоль при замерах)
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int ch) override { return ch; }
+    streamsize xsputn(const char*, streamsize count) override { return count; }
+};
+
+class ConsoleSilencer {
+private:
+    NullBuffer nullBuffer;
+    streambuf* original;
+    
+public:
+    ConsoleSilencer() : original(cout.rdbuf(&nullBuffer)) {}
+    ~ConsoleSilencer() { cout.rdbuf(original); }
+};
+
+long peakRssKb() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+// Результаты одного замера: длительности отдельных выборок в наносекундах
+class BenchmarkCase {
+private:
+    string name;
+    string sampleUnit;
+    vector<int64_t> samples;
+    uint64_t startAllocations;
+    uint64_t startBytes;
+    uint64_t allocations;
+    uint64_t bytes;
+    chrono::steady_clock::time_point sampleStart;
+    
+    int64_t percentile(const vector<int64_t>& sorted, double p) const {
+        if (sorted.empty()) return 0;
+        return sorted[static_cast<size_t>(p * (sorted.size() - 1) + 0.5)];
+    }
+    
+public:
+    BenchmarkCase(const string& name, const string& sampleUnit)
+        : name(name), sampleUnit(sampleUnit), startAllocations(allocationCount.load()),
+          startBytes(allocatedBytes.load()), allocations(0), bytes(0) {}
+    
+    void begin() { sampleStart = chrono::steady_clock::now(); }
+    
+    void end() {
+        samples.push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - sampleStart).count());
+    }
+    
+    void finish() {
+        allocations = allocationCount.load() - startAllocations;
+        bytes = allocatedBytes.load() - startBytes;
+    }
+    
+    string toJson() const {
+        vector<int64_t> sorted = samples;
+        sort(sorted.begin(), sorted.end());
+        int64_t total = accumulate(sorted.begin(), sorted.end(), int64_t(0));
+        ostringstream json;
+        json << "{\"name\": \"" << name << "\", \"sample\": \"" << sampleUnit << "\", \"samples\": " << sorted.size()
+             << ", \"total_ms\": " << total / 1e6
+             << ", \"mean_ns\": " << (sorted.empty() ? 0 : total / static_cast<int64_t>(sorted.size()))
+             << ", \"p50_ns\": " << percentile(sorted, 0.50) << ", \"p90_ns\": " << percentile(sorted, 0.90)
+             << ", \"p99_ns\": " << percentile(sorted, 0.99) << ", \"max_ns\": " << percentile(sorted, 1.0)
+             << ", \"allocations\": " << allocations << ", \"allocated_bytes\": " << bytes << "}";
+        return json.str();
+    }
+};
+
+string benchmarkScale(size_t pipeCount, size_t stationCount, uint64_t seed, const string& workDirectory) {
+    const string dataFile = workDirectory + "benchmark_data.txt";
+    const size_t insertChunk = 1000;
+    const int fileRepeats = pipeCount <= 100000 ? 3 : 1;
+    vector<string> cases;
+    
+    PipeManager pipeManager;
+    StationManager stationManager;
+    NetworkGenerator generator(seed);
+    {
+        vector<Pipe> pipes;
+        vector<CompressorStation> stations;
+        for (size_t i = 1; i <= pipeCount; i++) pipes.push_back(generator.makePipe(static_cast<int>(i)));
+        for (size_t i = 1; i <= stationCount; i++) stations.push_back(generator.makeStation(static_cast<int>(i)));
+        
+        BenchmarkCase insertPipes("addObject(Pipe)", "insert of 1000 pipes");
+        for (size_t i = 0; i < pipes.size(); i += insertChunk) {
+            insertPipes.begin();
+            for (size_t j = i; j < min(i + insertChunk, pipes.size()); j++) pipeManager.addObject(pipes[j]);
+            insertPipes.end();
+        }
+        insertPipes.finish();
+        cases.push_back(insertPipes.toJson());
+        
+        BenchmarkCase insertStations("addObject(CompressorStation)", "insert of 1000 stations");
+        for (size_t i = 0; i < stations.size(); i += insertChunk) {
+            insertStations.begin();
+            for (size_t j = i; j < min(i + insertChunk, stations.size()); j++) stationManager.addObject(stations[j]);
+            insertStations.end();
+        }
+        insertStations.finish();
+        cases.push_back(insertStations.toJson());
+    }
+    
+    BenchmarkCase byName("findPipesByName", "query");
+    for (const char* filter : {"Магистраль", "Союз", "Отвод Ямбург-Тула", " 7", "нет такого имени"}) {
+        byName.begin();
+        set<int> found = pipeManager.findPipesByName(filter);
+        byName.end();
+    }
+    byName.finish();
+    cases.push_back(byName.toJson());
+    
+    // Первый нечеткий запрос строит триграммный индекс
+    BenchmarkCase fuzzyBuild("fuzzyIndexBuild", "first fuzzy query");
+    fuzzyBuild.begin();
+    pipeManager.findObjectsByNameFuzzy("Магистраль", 1, 10, true);
+    fuzzyBuild.end();
+    fuzzyBuild.finish();
+    cases.push_back(fuzzyBuild.toJson());
+    
+    BenchmarkCase fuzzy("findObjectsByNameFuzzy", "top-10 query");
+    for (const char* query : {"уренгои-помары", "Ямбург Тула", "Сила Сибри", "Северный паток", "Бованенкого"}) {
+        fuzzy.begin();
+        pipeManager.findObjectsByNameFuzzy(query, 2, 10, true);
+        fuzzy.end();
+    }
+    fuzzy.finish();
+    cases.push_back(fuzzy.toJson());
+    
+    BenchmarkCase byRepair("findPipesByRepair", "query");
+    for (int i = 0; i < 6; i++) {
+        byRepair.begin();
+        set<int> found = pipeManager.findPipesByRepair(i % 2 == 0);
+        byRepair.end();
+    }
+    byRepair.finish();
+    cases.push_back(byRepair.toJson());
+    
+    BenchmarkCase byUnused("findStationsByUnusedPercentage", "query");
+    for (double threshold : {0.0, 25.0, 50.0, 75.0, 100.0}) {
+        byUnused.begin();
+        set<int> found = stationManager.findStationsByUnusedPercentage(threshold);
+        byUnused.end();
+    }
+    byUnused.finish();
+    cases.push_back(byUnused.toJson());
+    
+    BenchmarkCase batchEdit("batchEditRepair", "batch over 1% of pipes");
+    for (int repeat = 0; repeat < 5; repeat++) {
+        set<int> ids;
+        for (size_t id = 1 + repeat; id <= pipeCount; id += 100) ids.insert(static_cast<int>(id));
+        batchEdit.begin();
+        pipeManager.batchEditRepair(ids);
+        batchEdit.end();
+    }
+    batchEdit.finish();
+    cases.push_back(batchEdit.toJson());
+    
+    BenchmarkCase save("saveToFile", "full save");
+    for (int repeat = 0; repeat < fileRepeats; repeat++) {
+        save.begin();
+        saveToFile(pipeManager, stationManager, dataFile);
+        save.end();
+    }
+    save.finish();
+    cases.push_back(save.toJson());
+    
+    BenchmarkCase load("loadFromFile", "full load");
+    for (int repeat = 0; repeat < fileRepeats; repeat++) {
+        load.begin();
+        loadFromFile(pipeManager, stationManager, dataFile);
+        load.end();
+    }
+    load.finish();
+    cases.push_back(load.toJson());
+    remove(dataFile.c_str());
+    
+    const string manifestFile = workDirectory + "benchmark_shards.mf";
+    const size_t shardCount = max<size_t>(8, defaultShardCount());
+    BenchmarkCase shardedSave("saveToShards", "full save into " + to_string(shardCount) + " shards");
+    for (int repeat = 0; repeat < fileRepeats; repeat++) {
+        shardedSave.begin();
+        saveToShards(pipeManager, stationManager, manifestFile, shardCount);
+        shardedSave.end();
+    }
+    shardedSave.finish();
+    cases.push_back(shardedSave.toJson());
+    
+    BenchmarkCase shardedLoad("loadFromShards", "full load");
+    for (int repeat = 0; repeat < fileRepeats; repeat++) {
+        shardedLoad.begin();
+        loadFromShards(pipeManager, stationManager, manifestFile);
+        shardedLoad.end();
+    }
+    shardedLoad.finish();
+    cases.push_back(shardedLoad.toJson());
+    
+    ShardManifest manifest;
+    if (readManifest(manifestFile, manifest)) {
+        for (const ShardInfo& shard : manifest.shards) remove((directoryOf(manifestFile) + shard.file).c_str());
+    }
+    remove(manifestFile.c_str());
+    
+    BenchmarkCase erase("deleteObject", "single delete");
+    vector<int> ids = pipeManager.getAllObjectIds();
+    mt19937_64 rng(seed);
+    size_t deletes = min<size_t>(ids.size(), 10000);
+    for (size_t i = 0; i < deletes; i++) {
+        swap(ids[i], ids[i + rng() % (ids.size() - i)]);
+        erase.begin();
+        pipeManager.deleteObject(ids[i]);
+        erase.end();
+    }
+    erase.finish();
+    cases.push_back(erase.toJson());
+    
+    ostringstream json;
+    json << "{\"pipes\": " << pipeCount << ", \"stations\": " << stationCount << ", \"cases\": [\n";
+    for (size_t i = 0; i < cases.size(); i++) {
+        json << "      " << cases[i] << (i + 1 < cases.size() ? ",\n" : "\n");
+    }
+    size_t objectCount = pipeManager.getObjectCount() + stationManager.getObjectCount();
+    int64_t storageBytes = liveBytes(MemorySubsystem::Objects) + liveBytes(MemorySubsystem::Names);
+    json << "    ], \"peak_rss_kb\": " << peakRssKb();
+    if (memoryAccountingEnabled) {
+        json << ", \"bytes_per_object\": " << (objectCount ? storageBytes / static_cast<int64_t>(objectCount) : 0);
+    }
+    json << ", \"memory\": " << memoryUsageJson() << "}";
+    return json.str();
+}
+
+// Отдельный временный каталог, чтобы не затронуть файлы пользователя;
+// без mkdtemp - уникальный префикс имен в текущем каталоге
+bool makeBenchmarkDirectory(string& directory) {
+#if defined(__unix__) || defined(__APPLE__)
+    const char* base = getenv("TMPDIR");
+    string pattern = string(base && *base ? base : "/tmp") + "/pipeline-benchmark-XXXXXX";
+    if (!mkdtemp(&pattern[0])) return false;
+    directory = pattern + "/";
+#else
+    directory = "pipeline-benchmark-" + to_string(time(nullptr)) + "-";
+#endif
+    return true;
+}
+
+void removeBenchmarkDirectory(const string& directory) {
+#if defined(__unix__) || defined(__APPLE__)
+    rmdir(directory.c_str());
+#else
+    (void)directory;
+#endif
+}
+
+// Верхняя граница держит ID в пределах int и исключает переполнение scale *= 10
+const size_t MIN_BENCHMARK_SCALE = 1000;
+const size_t MAX_BENCHMARK_SCALE = 100000000;
+
+// Прогон бенчмарка по масштабам 10^3 .. maxScale; на каждую станцию приходится 4 трубы
+bool runBenchmark(size_t maxScale, const string& outputFile) {
+    const uint64_t seed = 42;
+    string workDirectory;
+    if (!makeBenchmarkDirectory(workDirectory)) {
+        cerr << "Не удалось создать временный каталог для бенчмарка\n";
+        return false;
+    }
+    
+    vector<string> results;
+    logger.setMuted(true);
+    for (size_t scale = MIN_BENCHMARK_SCALE; scale <= maxScale; scale *= 10) {
+        cerr << "Бенчмарк: " << scale << " труб...\n";
+        ConsoleSilencer silencer;
+        results.push_back(benchmarkScale(scale, scale / 4, seed, workDirectory));
+    }
+    logger.setMuted(false);
+    removeBenchmarkDirectory(workDirectory);
+    
+    ostringstream json;
+    json << "{\n  \"seed\": " << seed << ",\n  \"scales\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        json << "    " << results[i] << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    json << "  ]\n}\n";
+    
+    cout << json.str();
+    if (!outputFile.empty()) {
+        ofstream file(outputFile);
+        file << json.str();
+    }
+    return true;
 }
 
 // Функции пользовательского интерфейса
+template<typename Manager>
+void showFuzzyNameSearch(const Manager& manager) {
+    string query = getStringInput("Введите название (допускаются опечатки): ");
+    int maxDistance = getValidInput<int>("Допустимое число опечаток (0-3): ", 0, 3);
+    int topK = getValidInput<int>("Сколько лучших результатов показать: ", 1, 1000);
+    bool caseInsensitive = getBoolInput("Без учета регистра? (0 - нет, 1 - да): ");
+    
+    vector<FuzzyMatch> matches = manager.findObjectsByNameFuzzy(query, maxDistance, topK, caseInsensitive);
+    cout << "\nНайдено: " << matches.size() << "\n";
+    vector<int> ids;
+    for (size_t i = 0; i < matches.size(); i++) {
+        cout << i + 1 << ". ID " << matches[i].id << " - опечаток: " << matches[i].distance << "\n";
+        ids.push_back(matches[i].id);
+    }
+    manager.showObjects(ids);
+}
+
 void showPipeSearchMenu(PipeManager& pipeManager) {
     if (!pipeManager.hasObjects()) {
         cout << "Ошибка! Нет созданных труб.\n";
@@ -547,22 +3569,18 @@ void showPipeSearchMenu(PipeManager& pipeManager) {
     cout << "\n=== Поиск труб ===\n";
     cout << "1. Поиск по названию\n";
     cout << "2. Поиск по статусу ремонта\n";
+    cout << "3. Нечеткий поиск по названию (с опечатками)\n";
     cout << "0. Назад\n";
     cout << "Выберите тип поиска: ";
     
-    int choice = getValidInput<int>("", 0, 2);
+    int choice = getValidInput<int>("", 0, 3);
     
     switch (choice) {
         case 1: {
             string nameFilter = getStringInput("Введите название или часть названия для поиска: ");
             set<int> foundPipes = pipeManager.findPipesByName(nameFilter);
             cout << "\nНайдено труб: " << foundPipes.size() << "\n";
-            for (int id : foundPipes) {
-                if (auto pipe = pipeManager.getObject(id)) {
-                    pipe->print();
-                    cout << "---\n";
-                }
-            }
+            pipeManager.showObjects(foundPipes);
             break;
         }
         case 2: {
@@ -574,14 +3592,12 @@ void showPipeSearchMenu(PipeManager& pipeManager) {
             
             set<int> foundPipes = pipeManager.findPipesByRepair(inRepair);
             cout << "\nНайдено труб: " << foundPipes.size() << "\n";
-            for (int id : foundPipes) {
-                if (auto pipe = pipeManager.getObject(id)) {
-                    pipe->print();
-                    cout << "---\n";
-                }
-            }
+            pipeManager.showObjects(foundPipes);
             break;
         }
+        case 3:
+            showFuzzyNameSearch(pipeManager);
+            break;
         case 0:
             return;
     }
@@ -596,41 +3612,50 @@ void showStationSearchMenu(StationManager& stationManager) {
     cout << "\n=== Поиск компрессорных станций ===\n";
     cout << "1. Поиск по названию\n";
     cout << "2. Поиск по проценту незадействованных цехов\n";
+    cout << "3. Нечеткий поиск по названию (с опечатками)\n";
     cout << "0. Назад\n";
     cout << "Выберите тип поиска: ";
     
-    int choice = getValidInput<int>("", 0, 2);
+    int choice = getValidInput<int>("", 0, 3);
     
     switch (choice) {
         case 1: {
             string nameFilter = getStringInput("Введите название или часть названия для поиска: ");
             set<int> foundStations = stationManager.findStationsByName(nameFilter);
             cout << "\nНайдено станций: " << foundStations.size() << "\n";
-            for (int id : foundStations) {
-                if (auto station = stationManager.getObject(id)) {
-                    station->print();
-                    cout << "---\n";
-                }
-            }
+            stationManager.showObjects(foundStations);
             break;
         }
         case 2: {
             double minPercentage = getValidInput<double>("Введите минимальный процент незадействованных цехов: ", 0.0, 100.0);
             set<int> foundStations = stationManager.findStationsByUnusedPercentage(minPercentage);
             cout << "\nНайдено станций: " << foundStations.size() << "\n";
-            for (int id : foundStations) {
-                if (auto station = stationManager.getObject(id)) {
-                    station->print();
-                    cout << "---\n";
-                }
-            }
+            stationManager.showObjects(foundStations);
             break;
         }
+        case 3:
+            showFuzzyNameSearch(stationManager);
+            break;
         case 0:
             return;
     }
 }
 
+BulkMode getBulkModeInput() {
+    return getBoolInput("Применить атомарно - всё или ничего? (0 - нет, 1 - да): ") ? BulkMode::Atomic : BulkMode::BestEffort;
+}
+
+void printBulkResult(const BulkResult& result) {
+    if (!result.committed) {
+        cout << "Операция отменена: не найдено " << result.missing << ", не подходит " << result.rejected << " объектов.\n";
+        return;
+    }
+    cout << "Изменено объектов: " << result.applied << " из " << result.requested;
+    if (result.missing) cout << ", не найдено: " << result.missing;
+    if (result.rejected) cout << ", пропущено: " << result.rejected;
+    cout << "\n";
+}
+
 void showBatchEditMenu(PipeManager& pipeManager) {
     if (!pipeManager.hasObjects()) {
         cout << "Ошибка! Нет созданных труб.\n";
@@ -671,18 +3696,18 @@ void showBatchEditMenu(PipeManager& pipeManager) {
     }
     
     cout << "\nНайдено труб: " << foundPipes.size() << "\n";
-    for (int id : foundPipes) {
-        if (auto pipe = pipeManager.getObject(id)) {
-            pipe->print();
-        }
-    }
+    pipeManager.showObjects(foundPipes);
     
     cout << "\nВыберите действие:\n";
     cout << "1. Изменить статус ремонта ВСЕХ найденных труб\n";
     cout << "2. Выбрать конкретные трубы для редактирования\n";
+    cout << "3. Установить статус ремонта ВСЕМ найденным трубам\n";
+    cout << "4. Изменить диаметр ВСЕХ найденных труб\n";
+    cout << "5. Удалить ВСЕ найденные трубы\n";
     cout << "0. Отмена\n";
     
-    int choice = getValidInput<int>("", 0, 2);
+    int choice = getValidInput<int>("", 0, 5);
+    vector<int> targets(foundPipes.begin(), foundPipes.end());
     
     if (choice == 1) {
         pipeManager.batchEditRepair(foundPipes);
@@ -708,6 +3733,68 @@ void showBatchEditMenu(PipeManager& pipeManager) {
             pipeManager.batchEditRepair(selectedPipes);
             cout << "Статус ремонта изменен для " << selectedPipes.size() << " труб.\n";
         }
+    } else if (choice == 3) {
+        bool inRepair = getBoolInput("Трубы в ремонте? (0 - нет, 1 - да): ");
+        printBulkResult(pipeManager.bulkSetRepair(targets, inRepair, getBulkModeInput()));
+    } else if (choice == 4) {
+        PipeAttributes attributes;
+        attributes.diameter = getValidInput<int>("Введите новый диаметр (мм): ", 1);
+        printBulkResult(pipeManager.bulkSetAttributes(targets, attributes, getBulkModeInput()));
+    } else if (choice == 5) {
+        printBulkResult(pipeManager.bulkDelete(targets, getBulkModeInput()));
+    }
+}
+
+void showStationBatchEditMenu(StationManager& stationManager) {
+    if (!stationManager.hasObjects()) {
+        cout << "Ошибка! Нет созданных компрессорных станций.\n";
+        return;
+    }
+    
+    cout << "\n=== Пакетное редактирование станций ===\n";
+    
+    string nameFilter = getStringInput("Фильтр по названию (оставьте пустым чтобы пропустить): ");
+    double minPercentage = getValidInput<double>("Минимальный процент незадействованных цехов (0 - без фильтра): ", 0.0, 100.0);
+    
+    set<int> foundStations = stationManager.findStationsByName(nameFilter);
+    if (minPercentage > 0) {
+        set<int> percentageFiltered = stationManager.findStationsByUnusedPercentage(minPercentage);
+        set<int> intersection;
+        set_intersection(foundStations.begin(), foundStations.end(),
+                         percentageFiltered.begin(), percentageFiltered.end(),
+                         inserter(intersection, intersection.begin()));
+        foundStations = intersection;
+    }
+    
+    if (foundStations.empty()) {
+        cout << "Станции по заданному фильтру не найдены.\n";
+        return;
+    }
+    
+    cout << "\nНайдено станций: " << foundStations.size() << "\n";
+    stationManager.showObjects(foundStations);
+    
+    cout << "\nВыберите действие:\n";
+    cout << "1. Запустить цехи на всех найденных станциях\n";
+    cout << "2. Остановить цехи на всех найденных станциях\n";
+    cout << "3. Изменить классификацию всех найденных станций\n";
+    cout << "4. Удалить все найденные станции\n";
+    cout << "0. Отмена\n";
+    
+    int choice = getValidInput<int>("", 0, 4);
+    vector<int> targets(foundStations.begin(), foundStations.end());
+    
+    if (choice == 1 || choice == 2) {
+        int count = getValidInput<int>("Количество цехов на станцию: ", 1);
+        BulkMode mode = getBulkModeInput();
+        printBulkResult(choice == 1 ? stationManager.bulkStartWorkshops(targets, count, mode)
+                                    : stationManager.bulkStopWorkshops(targets, count, mode));
+    } else if (choice == 3) {
+        StationAttributes attributes;
+        attributes.classification = getStringInput("Введите новую классификацию: ");
+        printBulkResult(stationManager.bulkSetAttributes(targets, attributes, getBulkModeInput()));
+    } else if (choice == 4) {
+        printBulkResult(stationManager.bulkDelete(targets, getBulkModeInput()));
     }
 }
 
@@ -732,6 +3819,57 @@ void showSearchMenu(PipeManager& pipeManager, StationManager& stationManager) {
     }
 }
 
+void showMemoryReport(const PipeManager& pipeManager, const StationManager& stationManager) {
+    cout << "\n=== Потребление памяти ===\n";
+    printMemoryUsage();
+    
+    size_t objectCount = pipeManager.getObjectCount() + stationManager.getObjectCount();
+    if (memoryAccountingEnabled && objectCount) {
+        int64_t storage = liveBytes(MemorySubsystem::Objects) + liveBytes(MemorySubsystem::Names);
+        cout << "Объектов: " << objectCount << ", байт на объект: " << storage / static_cast<int64_t>(objectCount)
+             << " (с индексами: " << (storage + liveBytes(MemorySubsystem::Indexes)) / static_cast<int64_t>(objectCount) << ")\n";
+    }
+}
+
+void showProfilerMenu() {
+    cout << "\n=== Профилирование ===\n";
+    cout << "1. " << (profiler.isEnabled() ? "Выключить" : "Включить") << " профилирование\n";
+    cout << "2. Статистика задержек\n";
+    cout << "3. Сохранить трассировку (Chrome trace JSON)\n";
+    cout << "4. Очистить собранные события\n";
+    cout << "0. Назад\n";
+    
+    int choice = getValidInput<int>("Выберите действие: ", 0, 4);
+    
+    switch (choice) {
+        case 1:
+            profiler.setEnabled(!profiler.isEnabled());
+            logger.log(string("Профилирование ") + (profiler.isEnabled() ? "включено" : "выключено"));
+            break;
+        case 2:
+            profiler.printStats();
+            cout << "\n";
+            printMemoryUsage();
+            break;
+        case 3: {
+            string filename = getStringInput("Введите имя файла трассировки: ");
+            if (profiler.writeChromeTrace(filename)) {
+                logger.log("Трассировка сохранена в файл: " + filename);
+                cout << "Сохранено событий: " << profiler.eventCount() << "\n";
+            } else {
+                cout << "Ошибка создания файла!\n";
+            }
+            break;
+        }
+        case 4:
+            profiler.reset();
+            cout << "События очищены.\n";
+            break;
+        case 0:
+            return;
+    }
+}
+
 // Главное меню
 void showMainMenu(PipeManager& pipeManager, StationManager& stationManager) {
     while (true) {
@@ -765,9 +3903,29 @@ void showMainMenu(PipeManager& pipeManager, StationManager& stationManager) {
         cout << "\n";
         
         cout << "10. Загрузить данные\n";
+        
+        cout << "11. Экспорт в Apache Arrow";
+        if (!pipeManager.hasObjects() && !stationManager.hasObjects()) cout << " (недоступно - нет данных)";
+        cout << "\n";
+        
+        cout << "12. Импорт из Apache Arrow\n";
+        cout << "13. Профилирование (" << (profiler.isEnabled() ? "включено" : "выключено") << ")\n";
+        
+        cout << "14. Пакетное редактирование станций";
+        if (!stationManager.hasObjects()) cout << " (недоступно - нет станций)";
+        cout << "\n";
+        
+        cout << "15. Слияние с файлом (загрузить только изменения)\n";
+        
+        cout << "16. Сохранить данные в шарды (параллельно)";
+        if (!pipeManager.hasObjects() && !stationManager.hasObjects()) cout << " (недоступно - нет данных)";
+        cout << "\n";
+        
+        cout << "17. Загрузить данные из шардов\n";
+        cout << "18. Потребление памяти\n";
         cout << "0. Выход\n";
         
-        int choice = getValidInput<int>("Выберите действие: ", 0, 10);
+        int choice = getValidInput<int>("Выберите действие: ", 0, 18);
         
         switch (choice) {
             case 0:
@@ -837,11 +3995,69 @@ void showMainMenu(PipeManager& pipeManager, StationManager& stationManager) {
             case 10:
                 loadFromFile(pipeManager, stationManager, getStringInput("Введите имя файла для загрузки: "));
                 break;
+            case 11:
+                if (!pipeManager.hasObjects() && !stationManager.hasObjects()) {
+                    cout << "Ошибка! Нет данных для экспорта.\n";
+                    break;
+                }
+                exportToArrow(pipeManager, stationManager, getStringInput("Введите базовое имя файлов для экспорта: "));
+                break;
+            case 12:
+                importFromArrow(pipeManager, stationManager, getStringInput("Введите базовое имя файлов для импорта: "));
+                break;
+            case 13:
+                showProfilerMenu();
+                break;
+            case 14:
+                if (!stationManager.hasObjects()) {
+                    cout << "Ошибка! Нет созданных станций.\n";
+                    break;
+                }
+                showStationBatchEditMenu(stationManager);
+                break;
+            case 15: {
+                string filename = getStringInput("Введите имя файла для слияния: ");
+                MergePolicy policy = getValidInput<int>("При конфликте: 1 - принять данные файла, 2 - сохранить локальные изменения: ", 1, 2) == 1
+                    ? MergePolicy::PreferIncoming : MergePolicy::PreferLocal;
+                bool deleteMissing = getBoolInput("Удалять объекты, отсутствующие в файле? (0 - нет, 1 - да): ");
+                mergeFromFile(pipeManager, stationManager, filename, policy, deleteMissing);
+                break;
+            }
+            case 16:
+                if (!pipeManager.hasObjects() && !stationManager.hasObjects()) {
+                    cout << "Ошибка! Нет данных для сохранения.\n";
+                    break;
+                }
+                saveToShards(pipeManager, stationManager, getStringInput("Введите имя файла манифеста: "));
+                break;
+            case 17:
+                loadFromShards(pipeManager, stationManager, getStringInput("Введите имя файла манифеста: "));
+                break;
+            case 18:
+                showMemoryReport(pipeManager, stationManager);
+                break;
         }
     }
 }
 
-int main() {
+// Запуск: без аргументов - интерактивное меню;
+// --benchmark [максимальный масштаб] [файл JSON] - бенчмарк горячих путей
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--benchmark") {
+        size_t maxScale = 100000;
+        if (argc > 2) {
+            const char* end = argv[2] + strlen(argv[2]);
+            auto parsed = from_chars(argv[2], end, maxScale);
+            if (parsed.ec != errc() || parsed.ptr != end || maxScale < MIN_BENCHMARK_SCALE ||
+                maxScale > MAX_BENCHMARK_SCALE || argc > 4) {
+                cerr << "Использование: " << argv[0] << " --benchmark [максимальный масштаб от "
+                     << MIN_BENCHMARK_SCALE << " до " << MAX_BENCHMARK_SCALE << "] [файл JSON]\n";
+                return 1;
+            }
+        }
+        return runBenchmark(maxScale, argc > 3 ? argv[3] : "benchmark.json") ? 0 : 1;
+    }
+    
     cout << "Газотранспортная система - управление трубами и компрессорными станциями\n";
     logger.log("Запуск программы");
     